@@ -0,0 +1,322 @@
+#include "GrammarAlgorithms.h"
+#include "CYK_Algorithm.h"
+#include "Valiant_Algorithm.h"
+#include "Earley_Algorithm.h"
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+
+using fl::Grammar;
+using fl::algo::CompiledGrammar;
+
+
+namespace {
+    enum class Workload {
+        kDyck,
+        kExpression,
+        kJson,
+        kExampleBrackets,
+        kExampleLetters
+    };
+
+    enum class Engine {
+        kCYK,
+        kFilteredCYK,
+        kValiant,
+        kEarley
+    };
+
+    // The grammars are found by the absolute path, so the numbers don't depend on the working directory
+    std::string getGrammarPath(Workload workload) {
+        const std::string source_dir = GC_CYKP_SOURCE_DIR;
+
+        switch (workload) {
+            case Workload::kDyck:
+                return source_dir + "/benchmarks/assets/dyck_grammar.txt";
+            case Workload::kExpression:
+                return source_dir + "/benchmarks/assets/expression_grammar.txt";
+            case Workload::kJson:
+                return source_dir + "/benchmarks/assets/json_grammar.txt";
+            case Workload::kExampleBrackets:
+                return source_dir + "/examples/grammar.txt";
+            case Workload::kExampleLetters:
+                return source_dir + "/examples/grammar2.txt";
+        }
+
+        return {};
+    }
+
+    std::string readGrammarText(Workload workload) {
+        std::ifstream fin(getGrammarPath(workload));
+
+        if (!fin.good()) {
+            throw std::runtime_error("failed to open " + getGrammarPath(workload));
+        }
+
+        std::stringstream ss;
+        ss << fin.rdbuf();
+
+        return ss.str();
+    }
+
+    Grammar parseGrammar(const std::string& grammar_text) {
+        std::istringstream sin(grammar_text);
+        Grammar g;
+        sin >> g;
+
+        return g;
+    }
+
+    /**
+     * The texts are generated with a fixed seed and without std distributions,
+     * whose results differ between the standard libraries, so every run
+     * on every platform measures the same texts
+     */
+    class TextGenerator {
+    public:
+        explicit TextGenerator(size_t size) : m_size(size) {
+        }
+
+        std::string generate(Workload workload) {
+            m_text.clear();
+
+            switch (workload) {
+                case Workload::kDyck:
+                    generateDyck();
+                    break;
+                case Workload::kExpression:
+                    generateExpression();
+                    break;
+                case Workload::kJson:
+                    while (m_text.size() < m_size) {
+                        m_text.clear();
+                        generateJsonValue(0);
+                    }
+
+                    break;
+                case Workload::kExampleBrackets:
+                    m_text = std::string(m_size / 2, '(') + std::string(m_size / 2, ')');
+                    break;
+                case Workload::kExampleLetters:
+                    for (size_t i = 0; i < m_size; ++i) {
+                        m_text += chooseOf("ab");
+                    }
+
+                    break;
+            }
+
+            return m_text;
+        }
+
+    private:
+        size_t next(size_t bound) {
+            return static_cast<size_t>(m_rng() % bound);
+        }
+
+        char chooseOf(const std::string& chars) {
+            return chars[next(chars.size())];
+        }
+
+        void generateDyck() {
+            std::string stack;
+
+            while (m_text.size() + stack.size() < m_size) {
+                if (!stack.empty() && next(2) == 0) {
+                    m_text += stack.back();
+                    stack.pop_back();
+                } else {
+                    const bool is_round = next(2) == 0;
+                    m_text += is_round ? '(' : '[';
+                    stack += is_round ? ')' : ']';
+                }
+            }
+
+            m_text.append(stack.rbegin(), stack.rend());
+        }
+
+        void generateExpression() {
+            size_t depth = 0;
+
+            while (true) {
+                if (next(4) == 0) {
+                    m_text += '(';
+                    ++depth;
+                    continue;
+                }
+
+                for (size_t len = 1 + next(3); len > 0; --len) {
+                    m_text += chooseOf("0123456789");
+                }
+
+                for (; depth > 0 && next(3) == 0; --depth) {
+                    m_text += ')';
+                }
+
+                if (m_text.size() + depth >= m_size) {
+                    break;
+                }
+
+                m_text += chooseOf("+-*/");
+            }
+
+            m_text += std::string(depth, ')');
+        }
+
+        void generateJsonValue(size_t depth) {
+            // The deeper values are more likely to be simple, so the recursion ends
+            const size_t kind = depth > 8 ? 2 + next(3) : next(5);
+
+            switch (kind) {
+                case 0:
+                case 1: {
+                    const bool is_object = kind == 0;
+                    const size_t items_count = next(5);
+
+                    m_text += is_object ? '{' : '[';
+
+                    for (size_t i = 0; i < items_count; ++i) {
+                        if (i != 0) {
+                            m_text += ',';
+                        }
+
+                        if (is_object) {
+                            generateJsonString();
+                            m_text += ':';
+                        }
+
+                        generateJsonValue(depth + 1);
+                    }
+
+                    m_text += is_object ? '}' : ']';
+                    break;
+                }
+                case 2:
+                    generateJsonString();
+                    break;
+                case 3:
+                    for (size_t len = 1 + next(4); len > 0; --len) {
+                        m_text += chooseOf("0123456789");
+                    }
+
+                    break;
+                default:
+                    m_text += next(2) == 0 ? "true" : "null";
+                    break;
+            }
+        }
+
+        void generateJsonString() {
+            m_text += '\'';
+
+            for (size_t len = next(6); len > 0; --len) {
+                m_text += chooseOf("abcxyz");
+            }
+
+            m_text += '\'';
+        }
+
+    private:
+        size_t m_size;
+        std::string m_text;
+        std::mt19937_64 m_rng{2024};
+    };
+
+    void BM_ParseGrammar(benchmark::State& state, Workload workload) {
+        const std::string grammar_text = readGrammarText(workload);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(parseGrammar(grammar_text));
+        }
+    }
+
+    void BM_ConvertToChomskyForm(benchmark::State& state, Workload workload) {
+        const Grammar g = parseGrammar(readGrammarText(workload));
+
+        for (auto _ : state) {
+            Grammar converted = g;
+            fl::algo::convertToChomskyForm(converted, 0);
+            benchmark::DoNotOptimize(converted);
+        }
+    }
+
+    void BM_IsRecognized(benchmark::State& state, Workload workload, Engine engine) {
+        Grammar g = parseGrammar(readGrammarText(workload));
+        const std::string text = TextGenerator(static_cast<size_t>(state.range(0))).generate(workload);
+
+        CompiledGrammar cg;
+        fl::algo::earley::EarleyGrammar eg;
+        fl::algo::RecognitionOptions options;
+        options.is_prediction_filtered = engine == Engine::kFilteredCYK;
+
+        if (engine == Engine::kEarley) {
+            fl::algo::earley::initEarleyGrammar(eg, g);
+        } else {
+            fl::algo::convertToChomskyForm(g, 0);
+            fl::algo::initCompiledGrammar(cg, g);
+        }
+
+        bool is_recognized = false;
+
+        for (auto _ : state) {
+            switch (engine) {
+                case Engine::kCYK:
+                case Engine::kFilteredCYK:
+                    is_recognized = fl::algo::cyk::isRecognized(text, cg, options);
+                    break;
+                case Engine::kValiant:
+                    is_recognized = fl::algo::valiant::isRecognized(text, cg, options);
+                    break;
+                case Engine::kEarley:
+                    is_recognized = fl::algo::earley::isRecognized(text, eg);
+                    break;
+            }
+
+            benchmark::DoNotOptimize(is_recognized);
+        }
+
+        // Every generated text is in the language, so a "No" means a broken engine or generator
+        if (!is_recognized) {
+            state.SkipWithError("the generated text is not recognized");
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(text.size()));
+        state.counters["text_size"] = static_cast<double>(text.size());
+    }
+}  // namespace
+
+
+BENCHMARK_CAPTURE(BM_ParseGrammar, dyck, Workload::kDyck);
+BENCHMARK_CAPTURE(BM_ParseGrammar, expression, Workload::kExpression);
+BENCHMARK_CAPTURE(BM_ParseGrammar, json, Workload::kJson);
+BENCHMARK_CAPTURE(BM_ParseGrammar, example_brackets, Workload::kExampleBrackets);
+BENCHMARK_CAPTURE(BM_ParseGrammar, example_letters, Workload::kExampleLetters);
+
+BENCHMARK_CAPTURE(BM_ConvertToChomskyForm, dyck, Workload::kDyck);
+BENCHMARK_CAPTURE(BM_ConvertToChomskyForm, expression, Workload::kExpression);
+BENCHMARK_CAPTURE(BM_ConvertToChomskyForm, json, Workload::kJson);
+BENCHMARK_CAPTURE(BM_ConvertToChomskyForm, example_brackets, Workload::kExampleBrackets);
+BENCHMARK_CAPTURE(BM_ConvertToChomskyForm, example_letters, Workload::kExampleLetters);
+
+#define GC_CYKP_RECOGNITION_BENCHMARKS(name, workload, max_size)                                             \
+    BENCHMARK_CAPTURE(BM_IsRecognized, name##_cyk, workload, Engine::kCYK)                                   \
+        ->RangeMultiplier(4)->Range(16, max_size)->Unit(benchmark::kMicrosecond);                            \
+    BENCHMARK_CAPTURE(BM_IsRecognized, name##_cyk_filtered, workload, Engine::kFilteredCYK)                  \
+        ->RangeMultiplier(4)->Range(16, max_size)->Unit(benchmark::kMicrosecond);                            \
+    BENCHMARK_CAPTURE(BM_IsRecognized, name##_valiant, workload, Engine::kValiant)                           \
+        ->RangeMultiplier(4)->Range(16, max_size)->Unit(benchmark::kMicrosecond);                            \
+    BENCHMARK_CAPTURE(BM_IsRecognized, name##_earley, workload, Engine::kEarley)                             \
+        ->RangeMultiplier(4)->Range(16, max_size)->Unit(benchmark::kMicrosecond)
+
+GC_CYKP_RECOGNITION_BENCHMARKS(dyck, Workload::kDyck, 1024);
+GC_CYKP_RECOGNITION_BENCHMARKS(expression, Workload::kExpression, 1024);
+GC_CYKP_RECOGNITION_BENCHMARKS(json, Workload::kJson, 1024);
+GC_CYKP_RECOGNITION_BENCHMARKS(example_brackets, Workload::kExampleBrackets, 1024);
+GC_CYKP_RECOGNITION_BENCHMARKS(example_letters, Workload::kExampleLetters, 256);
+
+BENCHMARK_MAIN();
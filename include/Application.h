@@ -3,6 +3,12 @@
 #include "ExceptionController.h"
 #include "Talker.h"
 #include "ParsedArguments.h"
+#include "CompiledGrammar.h"
+#include "Earley_Algorithm.h"
+#include "GrammarAlgorithms.h"
+#include "Statistics.h"
+
+#include <string>
 
 namespace logic {
     class Application {
@@ -11,13 +17,44 @@ namespace logic {
 
         int exec(int argc, char* argv[]);
 
+    private:
+        // The grammar in the form the chosen engine works with. The Earley form is also
+        // filled for the CYK engines when the derivations are counted ('-w count')
+        struct PreparedGrammar {
+            fl::algo::CompiledGrammar cg;
+            fl::algo::earley::EarleyGrammar eg;
+        };
+
     private:
         void preparePaths(ui::ParsedArguments& pargs);
         void execRecognition(const ui::ParsedArguments& pargs);
+        void execBatchRecognition(const ui::ParsedArguments& pargs);
+        void execStreamRecognition(const ui::ParsedArguments& pargs);
         void execConversion(const ui::ParsedArguments& pargs);
 
+        void prepareGrammar(const ui::ParsedArguments& pargs, PreparedGrammar& prepared);
+        void loadCompiledGrammar(const ui::ParsedArguments& pargs, PreparedGrammar& prepared);
+        void loadEarleyGrammar(const ui::ParsedArguments& pargs, fl::algo::earley::EarleyGrammar& eg);
+        void saveCompiledGrammar(const ui::ParsedArguments& pargs, const fl::algo::CompiledGrammar& cg);
+        void saveStatistics(const ui::ParsedArguments& pargs);
+        fl::algo::ConversionOptions getConversionOptions(const ui::ParsedArguments& pargs);
+        static bool recognizeText(std::string_view text,
+                                  const PreparedGrammar& prepared,
+                                  const ui::ParsedArguments& pargs,
+                                  size_t threads_count,
+                                  fl::algo::RecognitionStatistics* statistics = nullptr);
+        void printSemiringValue(std::string_view text,
+                                const PreparedGrammar& prepared,
+                                const ui::ParsedArguments& pargs);
+        void outputParseForest(std::string_view text,
+                               const fl::algo::CompiledGrammar& cg,
+                               const ui::ParsedArguments& pargs);
+
     private:
         ExceptionController m_exceptor;
         std::shared_ptr<ui::Talker> m_talker;
+
+        // Collected only when the statistics are requested with '-S'
+        fl::algo::Statistics m_statistics;
     };
 }  // namespace logic
\ No newline at end of file
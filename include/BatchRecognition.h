@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace logic {
+    // The inputs are read, recognized and reported by blocks,
+    // so that a huge corpus is never kept in memory at once
+    constexpr size_t kBatchBlockSize = 4096;
+
+    struct BatchInput {
+        std::string name;
+        // The text itself for a corpus, the path to the text otherwise
+        std::string data;
+    };
+
+    /**
+     * BatchReader gives the inputs of a batch by blocks: the regular files of a directory
+     * in the sorted order, the files listed one per line in a file (a relative path is taken
+     * from the directory of the list) or every line of a corpus.
+     * Throws std::runtime_error if the list or the corpus can't be opened.
+     */
+    class BatchReader {
+    public:
+        BatchReader(const std::filesystem::path& batch_path, bool is_corpus);
+
+        [[nodiscard]] bool isCorpus() const noexcept { return m_is_corpus; }
+
+        // Replaces the block with the next kBatchBlockSize inputs at most, false if there are none
+        bool readBlock(std::vector<BatchInput>& block);
+
+    private:
+        bool m_is_corpus;
+
+        // A directory is expanded in the sorted order to keep the output reproducible
+        std::vector<std::string> m_directory_files;
+        size_t m_next_file{0};
+
+        std::ifstream m_list_fin;
+        std::filesystem::path m_list_directory;
+        size_t m_line_number{0};
+    };
+
+    /**
+     * Recognizes the inputs of the batch with the pool and writes "<input>\t<Yes|No>" for every one
+     * in the order of the batch. A listed file that can't be read gets "Failed to read" instead.
+     */
+    void recognizeBatch(BatchReader& reader,
+                        fl::algo::ThreadPool& pool,
+                        std::ostream& out,
+                        const std::function<bool(std::string_view text)>& recognize);
+}  // namespace logic
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fl::algo {
+    enum class SimdLevel {
+        kScalar,
+        kAVX2,
+        kAVX512
+    };
+
+    /**
+     * BitKernels are the word loops over the packed nonterminal bitsets of the charts.
+     * Every instruction set has its own table, the widest one supported by the CPU
+     * is chosen once at runtime, so the binary itself stays portable.
+     */
+    struct BitKernels {
+        // dst[0:words] |= src[0:words]
+        void (*or_words)(uint64_t* dst, const uint64_t* src, size_t words) noexcept;
+        // Checks whether a[0:words] & b[0:words] has at least one bit set
+        bool (*intersects)(const uint64_t* a, const uint64_t* b, size_t words) noexcept;
+        // dst[0:words] = a[0:words] & b[0:words], checks whether the result has at least one bit set
+        bool (*and_words)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) noexcept;
+        // Checks whether a[0:words] has no bits set
+        bool (*is_empty)(const uint64_t* a, size_t words) noexcept;
+        // Checks whether every bit of b[0:words] is set in a[0:words]
+        bool (*covers)(const uint64_t* a, const uint64_t* b, size_t words) noexcept;
+        SimdLevel level;
+    };
+
+    [[nodiscard]] SimdLevel detectSimdLevel() noexcept;
+
+    // The kernels of the level, the scalar ones if the level is not compiled in
+    [[nodiscard]] const BitKernels& getBitKernels(SimdLevel level) noexcept;
+
+    // The kernels of detectSimdLevel()
+    [[nodiscard]] const BitKernels& getBitKernels() noexcept;
+}  // namespace fl::algo
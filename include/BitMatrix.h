@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fl::algo {
+    using BitWord = uint64_t;
+
+    constexpr size_t kBitWordBits = 64;
+    constexpr size_t kBitTileSize = kBitWordBits;
+
+    /**
+     * Half-open range [begin, end) of rows, columns, bits or tiles
+     */
+    struct BitRange {
+        size_t begin;
+        size_t end;
+
+        [[nodiscard]] size_t size() const noexcept { return end - begin; }
+    };
+
+    /**
+     * BitTile is a 64 x 64 block of a boolean matrix: the element (r, c) is the bit c of rows[r]
+     */
+    struct BitTile {
+        BitWord rows[kBitTileSize];
+    };
+
+    // dst = src transposed
+    void transposeTile(BitTile& dst, const BitTile& src) noexcept;
+
+    /**
+     * TriangularBitMatrix is an upper triangular boolean matrix of tilesCount() * 64 rows.
+     * Only the tiles (I, J) with I <= J are allocated, so the matrix takes a half
+     * of the square one. The tiles are numbered column by column, the same way
+     * as the cells of the CYK chart (see triangularIndex in CYK_Chart.h).
+     */
+    class TriangularBitMatrix {
+    public:
+        TriangularBitMatrix() = default;
+        explicit TriangularBitMatrix(size_t tiles_count);
+
+        [[nodiscard]] size_t tilesCount() const noexcept { return m_tiles_count; }
+
+        // I <= J
+        [[nodiscard]] BitTile& tile(size_t I, size_t J) noexcept { return m_tiles[J * (J + 1) / 2 + I]; }
+        [[nodiscard]] const BitTile& tile(size_t I, size_t J) const noexcept { return m_tiles[J * (J + 1) / 2 + I]; }
+
+        // i / 64 <= j / 64
+        [[nodiscard]] bool test(size_t i, size_t j) const noexcept {
+            return (tile(i / kBitTileSize, j / kBitTileSize).rows[i % kBitTileSize] >> (j % kBitTileSize)) & 1u;
+        }
+
+        void set(size_t i, size_t j) noexcept {
+            tile(i / kBitTileSize, j / kBitTileSize).rows[i % kBitTileSize] |= BitWord{1} << (j % kBitTileSize);
+        }
+
+    private:
+        size_t m_tiles_count{0};
+        std::vector<BitTile> m_tiles;
+    };
+
+    // The ranges of the regions below are the ranges of tiles, every row range goes before the column one
+
+    // dst[rows][cols] |= src[rows][cols]
+    void orRegion(TriangularBitMatrix& dst, const TriangularBitMatrix& src, BitRange rows, BitRange cols) noexcept;
+
+    // dst[rows][cols] = 0
+    void clearRegion(TriangularBitMatrix& dst, BitRange rows, BitRange cols) noexcept;
+
+    /**
+     * dst[rows][cols] |= a[rows][mids] * b[mids][cols] over the boolean semiring
+     *
+     * Every set bit a[i][k] ORs the row b[k] of a tile into dst[i],
+     * so the product costs |rows| * |mids| * |cols| / 64 word operations (in bits).
+     * dst must not share memory with a or b.
+     */
+    void multiplyAdd(TriangularBitMatrix& dst,
+                     const TriangularBitMatrix& a,
+                     const TriangularBitMatrix& b,
+                     BitRange rows,
+                     BitRange mids,
+                     BitRange cols);
+
+    /**
+     * The same product as multiplyAdd, computed with the Method of Four Russians:
+     * the rows of a tile of b are taken in groups of 8, all 256 unions of a group are
+     * precomputed once, and then every row of a needs one table lookup per group
+     * instead of a separate OR for every set bit.
+     */
+    void multiplyAddFourRussians(TriangularBitMatrix& dst,
+                                 const TriangularBitMatrix& a,
+                                 const TriangularBitMatrix& b,
+                                 BitRange rows,
+                                 BitRange mids,
+                                 BitRange cols);
+
+    using MultiplyAddKernel = void (*)(TriangularBitMatrix& dst,
+                                       const TriangularBitMatrix& a,
+                                       const TriangularBitMatrix& b,
+                                       BitRange rows,
+                                       BitRange mids,
+                                       BitRange cols);
+
+    /**
+     * Calls f(bit) for every set bit of a[bits] in the increasing order
+     */
+    template <typename F>
+    void forEachBit(const BitWord* a, BitRange bits, F&& f) {
+        if (bits.begin >= bits.end) {
+            return;
+        }
+
+        const size_t first_word = bits.begin / kBitWordBits;
+        const size_t last_word = (bits.end - 1) / kBitWordBits;
+
+        for (size_t w = first_word; w <= last_word; ++w) {
+            BitWord word = a[w];
+
+            if (w == first_word) {
+                word &= ~BitWord{0} << (bits.begin % kBitWordBits);
+            }
+
+            if (w == last_word) {
+                word &= ~BitWord{0} >> (kBitWordBits - 1 - (bits.end - 1) % kBitWordBits);
+            }
+
+            for (; word != 0; word &= word - 1) {
+                f(w * kBitWordBits + __builtin_ctzll(word));
+            }
+        }
+    }
+}  // namespace fl::algo
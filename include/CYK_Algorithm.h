@@ -1,9 +1,18 @@
 #pragma once
 
 #include "Grammar.h"
+#include "CompiledGrammar.h"
+#include "CYK_Chart.h"
+#include "RecognitionOptions.h"
 
 #include <string_view>
 
 namespace fl::algo::cyk {
-    bool isRecognized(const std::string& text, const Grammar& g);
+    bool isRecognized(std::string_view text, const Grammar& g);
+    bool isRecognized(std::string_view text,
+                      const CompiledGrammar& cg,
+                      const RecognitionOptions& options = {});
+
+    // Fills the chart over the characters of the text, the chart must be made for text.size() symbols
+    void fillChart(Chart& chart, std::string_view text, const CompiledGrammar& cg);
 }  // namespace fl::cyk
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BitKernels.h"
+#include "CompiledGrammar.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fl::algo::cyk {
+    using ChartWord = uint64_t;
+
+    constexpr size_t kChartWordBits = 64;
+    constexpr size_t kChartAlignment = 64;
+
+    /**
+     * The triangular numbering of the chart cells shared by the CYK engines.
+     * Only the substrings text[begin:end] with 0 <= begin < end <= n have cells,
+     * they are numbered column by column: the cells ending at end go right after
+     * the cells ending at end - 1. So the chart over n symbols has n * (n + 1) / 2
+     * cells, and appending a symbol only appends a column.
+     */
+    [[nodiscard]] constexpr size_t triangularIndex(size_t begin, size_t end) noexcept {
+        return end * (end - 1) / 2 + begin;
+    }
+
+    [[nodiscard]] constexpr size_t triangularCellsCount(size_t symbols_count) noexcept {
+        return symbols_count * (symbols_count + 1) / 2;
+    }
+
+    /**
+     * Chart keeps all the CYK cells in one flat aligned buffer.
+     * Every cell is a packed bitset over compact nonterminal codes
+     * (see NonterminalCompression.h), so that a cell for text[pos:pos + len]
+     * holds the codes of all the nonterminals generating the substring.
+     *
+     * The cells are laid out by triangularIndex, so all the right parts
+     * cell(len - k, pos + k) of one cell(len, pos) are contiguous.
+     */
+    class Chart {
+    public:
+        Chart(size_t text_size, size_t nt_count);
+
+        [[nodiscard]] ChartWord* cell(size_t len, size_t pos) noexcept {
+            return m_buffer.get() + triangularIndex(pos, pos + len) * m_cell_words;
+        }
+
+        [[nodiscard]] const ChartWord* cell(size_t len, size_t pos) const noexcept {
+            return m_buffer.get() + triangularIndex(pos, pos + len) * m_cell_words;
+        }
+
+        [[nodiscard]] size_t cellWords() const noexcept { return m_cell_words; }
+        [[nodiscard]] size_t textSize() const noexcept { return m_text_size; }
+        [[nodiscard]] size_t bytes() const noexcept;
+
+    private:
+        struct AlignedDeleter {
+            void operator()(ChartWord* p) const noexcept;
+        };
+
+        size_t m_text_size;
+        size_t m_cell_words;
+        std::unique_ptr<ChartWord[], AlignedDeleter> m_buffer;
+    };
+
+    inline bool testBit(const ChartWord* cell, size_t code) noexcept {
+        return (cell[code / kChartWordBits] >> (code % kChartWordBits)) & 1u;
+    }
+
+    inline void setBit(ChartWord* cell, size_t code) noexcept {
+        cell[code / kChartWordBits] |= ChartWord{1} << (code % kChartWordBits);
+    }
+
+    /**
+     * CellCombiner does the cell operations of the CYK fills. The bit kernels are
+     * resolved once when the combiner is made, so the innermost loops call them directly.
+     * A combiner keeps a scratch bitset, so one combiner is used by one thread at a time.
+     */
+    class CellCombiner {
+    public:
+        explicit CellCombiner(const CompiledGrammar& cg);
+
+        [[nodiscard]] bool isEmpty(const ChartWord* cell) const noexcept {
+            return m_kernels.is_empty(cell, m_cell_words);
+        }
+
+        // Checks whether no rule A -> BC can add anything new to the cell
+        [[nodiscard]] bool isSaturated(const ChartWord* cell) const noexcept {
+            return m_kernels.covers(cell, m_cg.binary_heads.data(), m_cell_words);
+        }
+
+        /**
+         * cell |= {A | A -> BC, B in left, C in right}
+         *
+         * Only the pairs (B, C) whose left child is present in the left cell are visited.
+         * A left child with many pairs gets its right_partners intersected with the right cell
+         * at once, and then only the pairs with the right children of the intersection are visited.
+         */
+        void combine(ChartWord* cell, const ChartWord* left, const ChartWord* right) noexcept;
+
+    private:
+        const CompiledGrammar& m_cg;
+        const BitKernels& m_kernels;
+        size_t m_cell_words;
+        std::vector<ChartWord> m_partners;
+    };
+}  // namespace fl::algo::cyk
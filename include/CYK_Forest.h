@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fl::algo::cyk {
+    /**
+     * ParseForest is a shared packed parse forest of a text for a grammar in CNF.
+     *
+     * A node is a nonterminal with the span text[begin:end] it generates, every node is kept once
+     * however many derivations share it. The families of a node are the alternative ways
+     * to derive it: either the pair of the child nodes of a rule A -> BC or, if left is kNoNode,
+     * a terminal rule A -> t matching the whole span. So every tree of the text
+     * is a choice of one family in every node reached from the root.
+     *
+     * Only the nodes reachable from the root are kept.
+     */
+    struct ParseForest {
+        static constexpr size_t kNoNode = static_cast<size_t>(-1);
+
+        struct Node {
+            size_t nt_code;
+            size_t begin;
+            size_t end;
+            size_t families_begin;
+            size_t families_end;
+        };
+
+        struct Family {
+            size_t left;
+            size_t right;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Family> families;
+        size_t root{kNoNode};
+
+        [[nodiscard]] bool empty() const noexcept { return root == kNoNode; }
+    };
+
+    /**
+     * Fills the CYK chart of the text over the characters and reads the backpointers
+     * off it from the root down: a family (B, C, k) of the node (A, i, j) exists
+     * when A -> BC and the cells of text[i:k] and text[k:j] have B and C.
+     * The forest is empty if the text is not recognized.
+     *
+     * The backpointers are not recorded by the fill itself: that would keep the families
+     * of every cell, O(n^3 * |pairs|) of them in the worst case, most of them unreachable.
+     * Reading them off costs a second pass of O(n * |pairs of A|) per reachable node (A, i, j),
+     * so at most the cost of the fill, and the memory is only the forest.
+     */
+    void buildParseForest(ParseForest& forest, std::string_view text, const CompiledGrammar& cg);
+
+    /**
+     * Prints every node of the forest in a line:
+     * <node> <nonterminal> <begin> <end> : <family> | <family> ...
+     * where a family is either the two child nodes or the quoted terminal
+     */
+    void printParseForest(std::ostream& out,
+                          const ParseForest& forest,
+                          std::string_view text,
+                          const CompiledGrammar& cg);
+
+    // Prints the tree made of the first family of every node as (A (B "t") (C ...))
+    void printParseTree(std::ostream& out,
+                        const ParseForest& forest,
+                        std::string_view text,
+                        const CompiledGrammar& cg);
+}  // namespace fl::algo::cyk
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+#include "CYK_Chart.h"
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fl::algo::cyk {
+    /**
+     * IncrementalRecognizer takes a text in chunks and extends the CYK chart
+     * column by column: appending a character fills only the cells that end at it,
+     * the earlier cells are never recomputed.
+     *
+     * The cells are kept by triangularIndex, column j holds the cells
+     * for text[i:j] with i < j, so the chart grows at the end of one buffer.
+     *
+     * If prefixes are tracked, the recognizer also keeps the second chart:
+     * prefix(i, j) holds every A that generates some string starting with text[i:j].
+     * The text so far is a viable prefix (there is a sentence of the grammar
+     * starting with it) if and only if the start is in prefix(0, size()).
+     * Once the text stops being a viable prefix nothing can fix it, so the recognizer
+     * stops filling the charts and only counts the appended characters.
+     */
+    class IncrementalRecognizer {
+    public:
+        explicit IncrementalRecognizer(const CompiledGrammar& cg, bool is_prefix_tracked = false);
+
+        void append(std::string_view chunk);
+        void clear() noexcept;
+
+        // Checks whether the whole text appended so far is generated by the grammar
+        [[nodiscard]] bool isRecognized() const noexcept;
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+        // Only for the recognizer with tracked prefixes
+        [[nodiscard]] bool isViable() const noexcept { return m_viable_size == m_size; }
+        [[nodiscard]] size_t viablePrefixSize() const noexcept { return m_viable_size; }
+
+    private:
+        void appendSymbol(char ch);
+        void fillPrefixColumn(char ch);
+
+        [[nodiscard]] ChartWord* cell(size_t begin, size_t end) noexcept {
+            return m_cells.data() + triangularIndex(begin, end) * m_cell_words;
+        }
+
+        [[nodiscard]] ChartWord* prefix(size_t begin, size_t end) noexcept {
+            return m_prefixes.data() + triangularIndex(begin, end) * m_cell_words;
+        }
+
+    private:
+        const CompiledGrammar& m_cg;
+        bool m_is_prefix_tracked;
+        size_t m_cell_words;
+        CellCombiner m_combiner;
+        size_t m_size{0};
+        size_t m_viable_size{0};
+        TerminalMatcher::State m_matcher_state{TerminalMatcher::root()};
+        std::vector<ChartWord> m_cells;
+        std::vector<ChartWord> m_prefixes;
+
+        // (begin, state): text[begin:size()] is a path in the terminal trie
+        std::vector<std::pair<size_t, TerminalMatcher::State>> m_trie_walks;
+    };
+
+    /**
+     * Returns the length of the longest prefix of the text that can be completed
+     * to a sentence of the grammar. It is text.size() for a viable text, otherwise
+     * it is the position of the first offending character.
+     */
+    size_t findLongestViablePrefix(std::string_view text, const CompiledGrammar& cg);
+}  // namespace fl::algo::cyk
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+#include "CYK_Algorithm.h"
+#include "CYK_Chart.h"
+#include "RecognitionOptions.h"
+#include "Semiring.h"
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fl::algo::cyk {
+    using WeightedMatchCallback = std::function<void(size_t pos, size_t len, size_t nt_code, double weight)>;
+
+    /**
+     * Calls on_match for every occurrence of a non-empty terminal rule A -> t {weight}
+     * in the text. A repeated rule is reported once with its smallest weight,
+     * the same way CompiledGrammar keeps the repeated binary rules.
+     */
+    void findWeightedTerminalMatches(std::string_view text,
+                                     const CompiledGrammar& cg,
+                                     const WeightedMatchCallback& on_match);
+
+    // The weight of the rule start -> "", the grammar must generate the empty string
+    double getEmptyRuleWeight(const CompiledGrammar& cg);
+
+    /**
+     * Computes the CYK chart over the Semiring and returns the value of the start
+     * for the whole text: the sum over all the derivations of the products of
+     * the values of the applied rules (see Semiring.h).
+     *
+     * The boolean semiring is the plain recognition, so it is given to the bit engine.
+     * The other semirings share one traversal over a chart of values: the cells
+     * are filled by increasing length and only the nonterminals with non-zero values
+     * of a cell are kept in its live list to be visited by the longer cells.
+     *
+     * Only the characters are supported as symbols for the other semirings,
+     * the weights of the terminal rules are looked up by the matched text.
+     *
+     * The values are over the compiled grammar: the conversion to CNF merges
+     * derivations, so the derivations of the grammar as written are counted
+     * by earley::countDerivations.
+     */
+    template <typename Semiring>
+    typename Semiring::Value evaluate(std::string_view text,
+                                      const CompiledGrammar& cg,
+                                      const RecognitionOptions& options = {}) {
+        using Value = typename Semiring::Value;
+
+        if constexpr (std::is_same_v<Semiring, BooleanSemiring>) {
+            return isRecognized(text, cg, options);
+        } else {
+            if (options.is_token_level) {
+                throw std::invalid_argument("the weighted recognition works only with the characters as symbols.\n");
+            }
+
+            if (cg.empty()) {
+                return Semiring::zero();
+            }
+
+            if (text.empty()) {
+                return cg.generates_empty ? Semiring::fromWeight(getEmptyRuleWeight(cg)) : Semiring::zero();
+            }
+
+            const size_t n = text.size();
+            const size_t nt_count = cg.nt_count;
+            const size_t cells_count = triangularCellsCount(n);
+
+            std::vector<Value> values(cells_count * nt_count, Semiring::zero());
+            std::vector<std::vector<size_t>> live(cells_count);
+
+            auto cellValues = [&](size_t len, size_t pos) {
+                return values.data() + triangularIndex(pos, pos + len) * nt_count;
+            };
+
+            auto collectLive = [&](size_t len, size_t pos) {
+                const Value* cell = cellValues(len, pos);
+                auto& cell_live = live[triangularIndex(pos, pos + len)];
+
+                for (size_t a = 0; a < nt_count; ++a) {
+                    if (cell[a] != Semiring::zero()) {
+                        cell_live.push_back(a);
+                    }
+                }
+            };
+
+            findWeightedTerminalMatches(text, cg, [&](size_t pos, size_t len, size_t nt_code, double weight) {
+                Value& value = cellValues(len, pos)[nt_code];
+                value = Semiring::plus(value, Semiring::fromWeight(weight));
+            });
+
+            for (size_t pos = 0; pos < n; ++pos) {
+                collectLive(1, pos);
+            }
+
+            for (size_t len = 2; len <= n; ++len) {
+                for (size_t pos = 0; pos + len <= n; ++pos) {
+                    Value* cell = cellValues(len, pos);
+
+                    for (size_t k = 1; k < len; ++k) {
+                        const Value* left = cellValues(k, pos);
+                        const Value* right = cellValues(len - k, pos + k);
+
+                        if (live[triangularIndex(pos + k, pos + len)].empty()) {
+                            continue;
+                        }
+
+                        for (size_t b_nt_code : live[triangularIndex(pos, pos + k)]) {
+                            for (size_t p = cg.left_offsets[b_nt_code]; p < cg.left_offsets[b_nt_code + 1]; ++p) {
+                                const auto& pair = cg.pairs[p];
+
+                                if (right[pair.right] == Semiring::zero()) {
+                                    continue;
+                                }
+
+                                const Value children = Semiring::times(left[b_nt_code], right[pair.right]);
+
+                                for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                                    Value& value = cell[cg.heads[h]];
+                                    value = Semiring::plus(value,
+                                                           Semiring::times(Semiring::fromWeight(cg.head_weights[h]),
+                                                                           children));
+                                }
+                            }
+                        }
+                    }
+
+                    collectLive(len, pos);
+                }
+            }
+
+            return cellValues(n, 0)[cg.start_code];
+        }
+    }
+}  // namespace fl::algo::cyk
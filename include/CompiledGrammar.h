@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Grammar.h"
+#include "TerminalMatcher.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fl::algo {
+    // Below that the pairs of a left child are tested faster one by one than with its right_partners
+    constexpr size_t kPartnerRowMinPairs = 4;
+    constexpr size_t kNoPartnerRow = SIZE_MAX;
+
+    /**
+     * CompiledGrammar is a read-only form of a grammar in CNF that is built once
+     * and then used by the recognition engines. All the nonterminals are replaced
+     * with their compact codes (see NonterminalCompression.h).
+     *
+     * Binary rules A -> BC are grouped by their right side: every distinct pair (B, C)
+     * is stored once in pairs together with the range of its heads A in heads.
+     * The pairs are sorted by (B, C), and left_offsets is the index by the left child:
+     * the pairs with the left child B are pairs[left_offsets[B]:left_offsets[B + 1]].
+     *
+     * The weights of the rules (the {weight} annotations, 0 by default) are kept in
+     * terminal_rules and in head_weights: head_weights[h] is the weight of heads[h] -> BC.
+     *
+     * matcher is an automaton over the non-empty terminal rules used to seed the charts.
+     *
+     * leftCorners() is the reachability by left children: the bitset
+     * leftCorners()[B * nt_words:(B + 1) * nt_words] holds every A such that
+     * A =>* B... using only the left children of binary rules (B itself included).
+     *
+     * leftDescendants() is leftCorners() transposed: the bitset
+     * leftDescendants()[A * nt_words:(A + 1) * nt_words] holds every B such that A =>* B...
+     *
+     * Both take nt_count * nt_words words, so each of them is built on its first call:
+     * only the recognizer of the viable prefixes needs leftCorners(), and only
+     * the prediction filter needs leftDescendants(). The copies of a compiled grammar
+     * share them, the grammar is never changed once it is built.
+     *
+     * right_partners is the left child index as bitsets, kept only for the left children B
+     * with at least kPartnerRowMinPairs pairs: the bitset
+     * right_partners[partner_rows[B] * nt_words:(partner_rows[B] + 1) * nt_words] holds
+     * every C such that (B, C) is in pairs, and partner_rows[B] is kNoPartnerRow for the rest.
+     * binary_heads is the bitset of all the heads of binary rules: a chart cell
+     * that already has all of them cannot get anything new from the rules.
+     */
+    struct CompiledGrammar {
+        struct TerminalRule {
+            std::string terminal;  // all the terminals of the rule glued together
+            size_t nt_code;
+            double weight{0};
+        };
+
+        struct RulePair {
+            size_t left;
+            size_t right;
+            size_t heads_begin;
+            size_t heads_end;
+        };
+
+        size_t nt_count{0};
+        size_t start_code{0};
+        bool generates_empty{false};
+        std::vector<std::string> nt_names;
+        std::vector<TerminalRule> terminal_rules;
+        std::vector<RulePair> pairs;
+        std::vector<size_t> heads;
+        std::vector<double> head_weights;
+        std::vector<size_t> left_offsets;
+        TerminalMatcher matcher;
+        size_t nt_words{0};
+        std::vector<size_t> partner_rows;
+        std::vector<uint64_t> right_partners;
+        std::vector<uint64_t> binary_heads;
+
+        [[nodiscard]] bool empty() const noexcept { return nt_count == 0; }
+        [[nodiscard]] const RulePair* findPair(size_t left, size_t right) const noexcept;
+        [[nodiscard]] const std::vector<uint64_t>& leftCorners() const;
+        [[nodiscard]] const std::vector<uint64_t>& leftDescendants() const;
+
+    private:
+        struct LazyBitsets {
+            std::once_flag left_corners_flag;
+            std::vector<uint64_t> left_corners;
+            std::once_flag left_descendants_flag;
+            std::vector<uint64_t> left_descendants;
+        };
+
+        std::shared_ptr<LazyBitsets> m_lazy_bitsets{std::make_shared<LazyBitsets>()};
+    };
+
+    // g must be in CNF, throws std::invalid_argument if a rule with nonterminals is not A -> BC
+    void initCompiledGrammar(CompiledGrammar& cg, const Grammar& g);
+
+    using TerminalMatchCallback = std::function<void(size_t pos, size_t len, size_t nt_code)>;
+
+    /**
+     * Calls on_match for every occurrence of a non-empty terminal rule A -> t
+     * in the text: text[pos:pos + len] == t and nt_code is the code of A
+     */
+    void findTerminalMatches(std::string_view text,
+                             const CompiledGrammar& cg,
+                             const TerminalMatchCallback& on_match);
+}  // namespace fl::algo
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+#include "MappedFile.h"
+
+#include <ostream>
+#include <string_view>
+
+namespace fl::algo {
+    /**
+     * A compiled grammar file is a CompiledGrammar dumped as is, so that loading
+     * it needs neither parsing nor the conversion to CNF nor building the matcher.
+     *
+     * The file starts with a fixed header: the magic string, the format version,
+     * the machine word size and byte order, the scalar fields and a table of sections.
+     * Every section is a flat array (the rule pairs, the heads, the matcher nodes...)
+     * aligned to 8 bytes. The nonterminal names and the terminals are kept in
+     * string arenas indexed by offset arrays.
+     *
+     * The file is a cache for the machine that wrote it: a file written
+     * on a machine with another word size or byte order is rejected.
+     */
+    constexpr std::string_view kCompiledGrammarMagic{"GCCYKPCG", 8};
+
+    [[nodiscard]] bool isCompiledGrammarFile(std::string_view data) noexcept;
+
+    void saveCompiledGrammar(std::ostream& out, const CompiledGrammar& cg);
+
+    // Throws std::runtime_error if the file is not a valid compiled grammar
+    void initCompiledGrammar(CompiledGrammar& cg, const MappedFile& file);
+}  // namespace fl::algo
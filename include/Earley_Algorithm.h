@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Grammar.h"
+#include "Semiring.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fl::algo::earley {
+    /**
+     * EarleyGrammar is a grammar in any form flattened for the Earley recognizer,
+     * so it is built straight from the result of operator>> without any conversion.
+     *
+     * The nonterminals are replaced with their compact codes (see NonterminalCompression.h).
+     * Every maximal run of terminals in a right side is glued into one terminal string,
+     * the empty terminals disappear, so a rule A -> "" has no symbols at all.
+     * The rules of A are rules[rule_offsets[A]:rule_offsets[A + 1]].
+     */
+    struct EarleyGrammar {
+        struct Symbol {
+            size_t id;  // the nonterminal code or the index in terminals
+            bool is_terminal;
+        };
+
+        struct Rule {
+            size_t head;
+            size_t symbols_begin;
+            size_t symbols_end;
+        };
+
+        size_t nt_count{0};
+        size_t start_code{0};
+        std::vector<std::string> terminals;
+        std::vector<Symbol> symbols;
+        std::vector<Rule> rules;
+        std::vector<size_t> rule_offsets;
+        std::vector<bool> is_nullable;
+
+        [[nodiscard]] bool empty() const noexcept { return nt_count == 0; }
+    };
+
+    void initEarleyGrammar(EarleyGrammar& eg, const Grammar& g);
+
+    /**
+     * Recognizes the text with the Earley algorithm, the empty rules are handled
+     * as proposed by J. Aycock and R. N. Horspool: predicting a nullable nonterminal
+     * also moves the dot over it.
+     *
+     * The terminals are matched against the characters of the text,
+     * a terminal of several characters moves an item several positions ahead.
+     */
+    bool isRecognized(std::string_view text, const EarleyGrammar& eg);
+    bool isRecognized(std::string_view text, const Grammar& g);
+
+    /**
+     * Counts the derivation trees of the text by the grammar as it is written, so the derivations
+     * merged by the conversion to CNF (the chain rules, the repeated rules) are all counted.
+     * The count saturates (see CountingSemiring) when there are infinitely many derivations,
+     * which happens with a cycle of chain rules or of nullable nonterminals.
+     *
+     * The terminals are matched against the characters of the text. The counts of all
+     * the prefixes of the rules are kept for every substring, so it takes
+     * O(|symbols| * n^2) memory and O(|symbols| * n^3) time.
+     */
+    CountingSemiring::Value countDerivations(std::string_view text, const EarleyGrammar& eg);
+    CountingSemiring::Value countDerivations(std::string_view text, const Grammar& g);
+}  // namespace fl::algo::earley
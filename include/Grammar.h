@@ -1,11 +1,15 @@
 #pragma once
 
+#include <cstddef>
+#include <deque>
 #include <iostream>
-#include <map>
+#include <iterator>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <exception>
 #include <functional>
+#include <optional>
 
 // I widely use the following short forms:
 // t = terminal
@@ -25,11 +29,6 @@ namespace fl {
     void assignOr(fl::TokenType& ref, fl::TokenType type);
 
 
-    struct TableEntry {
-        std::string token;
-        TokenType type = TokenType::kNothing;
-    };
-
     /**
      * TokenKey is a one-to-one mapping with tokens, which are strings
      */
@@ -37,29 +36,60 @@ namespace fl {
 
     /**
      * TokenTable is a structure to effectively handle all
-     * kind of tokens that appear in a grammar
+     * kind of tokens that appear in a grammar.
+     *
+     * The entries are kept in a vector indexed by TokenKey and every token string is stored
+     * once in an arena, the keys are found by the strings through an open addressing hash index.
+     * The key of an erased token is never given out again.
      */
-    struct TokenTable {
-        // todo: remove token duplication
-        using Table = std::map<TokenKey, TableEntry>;
-        using ReversedTable = std::map<std::string, TokenKey>;
-
-        Table table;
-        ReversedTable rtable;
-        size_t nt_count{0};
-
-        TokenKey insert(std::string&& s, TokenType type);
+    class TokenTable {
+    public:
+        TokenKey insert(std::string_view s, TokenType type);
         void erase(TokenKey key, TokenType type);
         void clear() noexcept;
+
+        [[nodiscard]] std::optional<TokenKey> find(std::string_view s) const;
+
+        // Throws std::out_of_range for a key that is not in the table
+        [[nodiscard]] std::string_view token(TokenKey key) const;
+
+        // All the keys are below keysEnd(), the erased ones have the type kNothing
+        [[nodiscard]] TokenType type(TokenKey key) const;
+        [[nodiscard]] size_t keysEnd() const noexcept { return m_entries.size(); }
+        [[nodiscard]] size_t ntCount() const noexcept { return m_nt_count; }
+
+    private:
+        struct Entry {
+            size_t offset;
+            size_t size;
+            size_t hash;
+            TokenType type;
+        };
+
+        static constexpr TokenKey kEmptySlot = static_cast<TokenKey>(-1);
+
+        [[nodiscard]] std::string_view entryToken(const Entry& entry) const noexcept;
+        [[nodiscard]] size_t findSlot(std::string_view s, size_t hash) const noexcept;
+        void eraseSlot(size_t slot) noexcept;
+        void rehash(size_t slots_count);
+
+    private:
+        std::vector<Entry> m_entries;
+        std::string m_arena;
+        std::vector<TokenKey> m_slots;
+        size_t m_tokens_count{0};
+        size_t m_nt_count{0};
     };
 
     /**
      * sequence holds all the TokenKeys from the right side of a rule
      * nt_indexes - indexes of TokenKeys in the sequence which TokenType is kNonTerminal
+     * weight - the optional {weight} annotation at the end of the right side
      */
     struct RuleRightSide {
         std::vector<TokenKey> sequence;
         std::vector<size_t> nt_indexes;
+        std::optional<double> weight;
 
         void pushTerminal(TokenKey key);
         void pushNonterminal(TokenKey key);
@@ -67,15 +97,118 @@ namespace fl {
 
     bool isRuleRightSidesEqual(const RuleRightSide& a,
                                const RuleRightSide& b,
-                               const TokenTable::Table& a_table,
-                               const TokenTable::Table& b_table);
+                               const TokenTable& a_table,
+                               const TokenTable& b_table);
     
     void outputRuleRightSide(std::ostream& out,
                              const RuleRightSide& rrs,
-                             const TokenTable::Table& table);
+                             const TokenTable& table);
 
     using MultiruleRightSide = std::vector<RuleRightSide>;
-    using MultirulesMap = std::map<TokenKey, MultiruleRightSide>;
+
+    /**
+     * MultirulesMap keeps the right sides of the nonterminals in a slot indexed by TokenKey,
+     * since the keys are dense (see TokenTable). It is walked in the order of the keys.
+     *
+     * The slots are in a deque, so a new key never moves the right sides of the others,
+     * and the iterators hold indexes, so they stay valid while the keys are inserted and erased.
+     * An iteration reaches the keys inserted after its position, as with std::map.
+     */
+    class MultirulesMap {
+    public:
+        using value_type = std::pair<const TokenKey, MultiruleRightSide>;
+
+        template<class Map, class Value>
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = MultirulesMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+
+            Iterator(Map* map, size_t index) : m_map(map), m_index(index) {
+                skipEmpty();
+            }
+
+            // A const_iterator is made from an iterator
+            template<class OtherMap, class OtherValue>
+            Iterator(const Iterator<OtherMap, OtherValue>& other) : m_map(other.m_map), m_index(other.m_index) {
+            }
+
+            reference operator*() const { return *m_map->m_slots[m_index]; }
+            pointer operator->() const { return &*m_map->m_slots[m_index]; }
+
+            Iterator& operator++() {
+                ++m_index;
+                skipEmpty();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator prev = *this;
+                ++*this;
+                return prev;
+            }
+
+            bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            template<class, class>
+            friend class Iterator;
+            friend class MultirulesMap;
+
+            // The end is not a slot index, so that it stays the end when the map grows
+            void skipEmpty() {
+                while (m_index < m_map->m_slots.size() && !m_map->m_slots[m_index]) {
+                    ++m_index;
+                }
+
+                if (m_index >= m_map->m_slots.size()) {
+                    m_index = kEndIndex;
+                }
+            }
+
+            Map* m_map;
+            size_t m_index;
+        };
+
+        using iterator = Iterator<MultirulesMap, value_type>;
+        using const_iterator = Iterator<const MultirulesMap, const value_type>;
+
+        MultirulesMap() = default;
+        MultirulesMap(const MultirulesMap& other) = default;
+        MultirulesMap(MultirulesMap&& other) noexcept = default;
+        MultirulesMap& operator=(const MultirulesMap& other);
+        MultirulesMap& operator=(MultirulesMap&& other) noexcept;
+
+        [[nodiscard]] iterator begin() { return {this, 0}; }
+        [[nodiscard]] iterator end() { return {this, kEndIndex}; }
+        [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+        [[nodiscard]] const_iterator end() const { return {this, kEndIndex}; }
+
+        [[nodiscard]] iterator find(TokenKey key);
+        [[nodiscard]] const_iterator find(TokenKey key) const;
+
+        // Both throw std::out_of_range for a key without right sides
+        [[nodiscard]] MultiruleRightSide& at(TokenKey key);
+        [[nodiscard]] const MultiruleRightSide& at(TokenKey key) const;
+
+        MultiruleRightSide& operator[](TokenKey key);
+        std::pair<iterator, bool> try_emplace(TokenKey key);
+        iterator erase(iterator it);
+        void clear() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    private:
+        static constexpr size_t kEndIndex = static_cast<size_t>(-1);
+
+        std::deque<std::optional<value_type>> m_slots;
+        size_t m_size{0};
+    };
 
     struct Grammar {
         TokenTable tntable;
@@ -98,6 +231,7 @@ namespace fl {
         void addRule(std::string&& nonterminal);
         void addRuleRightSide();
         void pushToken(std::string&& token, TokenType type);
+        void setRuleWeight(double weight);
 
         [[nodiscard]] Grammar&& getGrammar() &&;
 
@@ -2,8 +2,30 @@
 
 #include "Grammar.h"
 #include "CYK_Algorithm.h"
+#include "Statistics.h"
+
+#include <filesystem>
+#include <optional>
 
 namespace fl::algo {
-    void convertToChomskyForm(Grammar& g, int end_phase);
+    struct ConversionOptions {
+        // The number of the last phase to run, 0 runs all of them
+        int end_phase = 0;
+
+        // The grammar is saved in the directory after every pass, if it is set
+        std::optional<std::filesystem::path> dump_directory;
+
+        // Filled with the cost of every pass, if it is set
+        ConversionStatistics* statistics = nullptr;
+    };
+
+    /**
+     * Converts the grammar to the Chomsky form in 5 phases:
+     * 1 - deleting the useless nonterminals, 2 - splitting the mixed and long rules,
+     * 3 - deleting the empty rules, 4 - deleting the chain rules,
+     * 5 - deleting the nonterminals the previous phases have made useless
+     */
+    void convertToChomskyForm(Grammar& g, const ConversionOptions& options);
+    void convertToChomskyForm(Grammar& g, int end_phase, ConversionStatistics* statistics = nullptr);
     bool isInChomskyForm(const Grammar& g);
 }  // namespace fl::algo
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+#include "RecognitionOptions.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fl::algo {
+    /**
+     * Splits the text into the terminals of the grammar, taking the longest terminal
+     * at every position. tokens receives the matcher states of the terminals.
+     *
+     * Returns false if a part of the text doesn't start with any terminal.
+     */
+    bool tokenize(std::string_view text, const CompiledGrammar& cg, std::vector<TerminalMatcher::State>& tokens);
+
+    /**
+     * Prepares the symbols the engines run over: characters of the text or,
+     * if options.is_token_level is set, the tokens found by tokenize.
+     * on_match(pos, len, nt_code) is called for every terminal rule that covers
+     * symbols[pos:pos + len].
+     *
+     * Returns the number of the symbols or std::nullopt if the text can't be tokenized.
+     */
+    std::optional<size_t> findSymbolMatches(std::string_view text,
+                                            const CompiledGrammar& cg,
+                                            const RecognitionOptions& options,
+                                            const TerminalMatchCallback& on_match);
+}  // namespace fl::algo
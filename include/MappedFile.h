@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace fl {
+    /**
+     * MappedFile maps a whole file into the memory read-only and unmaps it
+     * in the destructor. An empty file is not mapped at all, data() is nullptr then.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& path);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        [[nodiscard]] const char* data() const noexcept { return m_data; }
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] std::string_view view() const noexcept { return {m_data, m_size}; }
+
+    private:
+        void unmap() noexcept;
+
+    private:
+        const char* m_data{nullptr};
+        size_t m_size{0};
+    };
+
+    /**
+     * TextInput gives the whole content of a file without copying it when possible:
+     * a regular file is mapped, anything else (a pipe, a terminal) is read into a buffer.
+     * Throws std::system_error if the file can't be read.
+     */
+    class TextInput {
+    public:
+        explicit TextInput(const std::filesystem::path& path);
+
+        [[nodiscard]] std::string_view view() const noexcept {
+            return m_file.empty() ? std::string_view(m_buffer) : m_file.view();
+        }
+
+    private:
+        MappedFile m_file;
+        std::string m_buffer;
+    };
+}  // namespace fl
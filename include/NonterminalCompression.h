@@ -2,8 +2,31 @@
 
 #include "Grammar.h"
 
+#include <vector>
+
 namespace fl::algo {
-    using NonterminalTokenKeyTable = std::unordered_map<TokenKey, size_t>;
+    /**
+     * NonterminalTokenKeyTable gives the nonterminals of a grammar the compact codes 0, 1, ...
+     * in the order of their keys, the codes are kept in a vector indexed by TokenKey
+     */
+    class NonterminalTokenKeyTable {
+    public:
+        static constexpr size_t kNoCode = static_cast<size_t>(-1);
+
+        // kNoCode for a key that is not a nonterminal
+        [[nodiscard]] size_t operator[](TokenKey key) const noexcept {
+            return key < m_codes.size() ? m_codes[key] : kNoCode;
+        }
+
+        [[nodiscard]] TokenKey key(size_t code) const noexcept { return m_keys[code]; }
+        [[nodiscard]] size_t size() const noexcept { return m_keys.size(); }
+
+    private:
+        friend void initNonterminalTokenKeyTable(NonterminalTokenKeyTable& nt_table, const Grammar& g);
+
+        std::vector<size_t> m_codes;
+        std::vector<TokenKey> m_keys;
+    };
 
     void initNonterminalTokenKeyTable(NonterminalTokenKeyTable& nt_table, const Grammar& g);
-}  // namespace fl::algo
\ No newline at end of file
+}  // namespace fl::algo
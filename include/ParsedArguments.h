@@ -10,15 +10,48 @@ namespace ui {
         enum class ProgramMode {
             kUnknown,
             kRecognition,
+            kBatchRecognition,
+            kStreamRecognition,
             kConversion
         };
+
+        enum class RecognitionEngine {
+            kCYK,
+            kValiant,
+            kEarley
+        };
+
+        enum class ProductKernel {
+            kNaive,
+            kFourRussians
+        };
+
+        enum class WeightSemiring {
+            kCount,
+            kBest
+        };
     
         bool need_help = false;
         bool is_already_converted = false;
+        bool is_token_level = false;
+        bool is_prediction_filtered = false;
+        bool need_viable_prefix = false;
+        bool need_parse_tree = false;
+        bool is_batch_corpus = false;
+        bool is_nul_separated = false;
         ProgramMode mode = ProgramMode::kUnknown;
+        RecognitionEngine engine = RecognitionEngine::kCYK;
+        ProductKernel kernel = ProductKernel::kNaive;
+        std::optional<WeightSemiring> semiring;
         std::optional<int> conversion_end_phase;
+        size_t threads_count = 1;
         std::optional<Path> text_filename;
+        std::optional<Path> batch_path;
         Path grammar_filename;
         std::optional<Path> converted_grammar_filename;
+        std::optional<Path> compiled_grammar_filename;
+        std::optional<Path> forest_filename;
+        std::optional<Path> stats_filename;
+        std::optional<Path> dump_directory;
     };
 }  // namespace ui
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace fl::algo {
+    struct RecognitionStatistics;
+
+    /**
+     * Settings shared by the recognition engines
+     */
+    struct RecognitionOptions {
+        // Kernel for the boolean matrix products of the matrix-based engines
+        enum class ProductKernel {
+            kNaive,
+            kFourRussians
+        };
+
+        size_t threads_count = 1;
+        ProductKernel kernel = ProductKernel::kNaive;
+
+        // Run over the tokens of the longest-match lexer instead of the characters
+        bool is_token_level = false;
+
+        // Keep in a CYK cell only the nonterminals predicted top-down by the text before it
+        bool is_prediction_filtered = false;
+
+        // Filled with the cost of the recognition by the "cyk" engine, if it is set
+        RecognitionStatistics* statistics = nullptr;
+    };
+}  // namespace fl::algo
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace fl::algo {
+    /**
+     * The semirings a CYK chart can be computed over. Every semiring defines
+     * the Value of a cell entry, zero() for "no derivation", one(), plus() to join
+     * alternative derivations, times() to chain the parts of one derivation
+     * and fromWeight() to turn the weight of a rule into the value of applying it.
+     */
+
+    // Whether there is a derivation at all
+    struct BooleanSemiring {
+        using Value = bool;
+
+        static Value zero() noexcept { return false; }
+        static Value one() noexcept { return true; }
+        static Value plus(Value a, Value b) noexcept { return a || b; }
+        static Value times(Value a, Value b) noexcept { return a && b; }
+        static Value fromWeight(double) noexcept { return true; }
+    };
+
+    // The number of derivations, it sticks at the maximum of uint64_t instead of overflowing
+    struct CountingSemiring {
+        using Value = uint64_t;
+
+        static constexpr Value kSaturated = std::numeric_limits<Value>::max();
+
+        static Value zero() noexcept { return 0; }
+        static Value one() noexcept { return 1; }
+
+        static Value plus(Value a, Value b) noexcept {
+            Value res;
+            return __builtin_add_overflow(a, b, &res) ? kSaturated : res;
+        }
+
+        static Value times(Value a, Value b) noexcept {
+            Value res;
+            return __builtin_mul_overflow(a, b, &res) ? kSaturated : res;
+        }
+
+        static Value fromWeight(double) noexcept { return 1; }
+    };
+
+    // The smallest total weight of a derivation, so the weights are costs such as -log(p)
+    struct TropicalSemiring {
+        using Value = double;
+
+        static Value zero() noexcept { return std::numeric_limits<Value>::infinity(); }
+        static Value one() noexcept { return 0; }
+        static Value plus(Value a, Value b) noexcept { return a < b ? a : b; }
+        static Value times(Value a, Value b) noexcept { return a + b; }
+        static Value fromWeight(double weight) noexcept { return weight; }
+    };
+}  // namespace fl::algo
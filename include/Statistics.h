@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fl::algo {
+    using StatisticsClock = std::chrono::steady_clock;
+
+    /**
+     * The cost of one pass of the conversion to the Chomsky form,
+     * a skipped pass could not change the grammar and has not run
+     */
+    struct PassStatistics {
+        std::string name;
+        bool is_skipped = false;
+        double seconds = 0;
+        size_t nonterminals_before = 0;
+        size_t nonterminals_after = 0;
+        size_t rules_before = 0;
+        size_t rules_after = 0;
+    };
+
+    struct ConversionStatistics {
+        std::vector<PassStatistics> passes;
+    };
+
+    /**
+     * The cost of one recognition: init is the search of the terminals and the allocation
+     * of the chart, fill is the filling of the chart, cells_touched is the number of the cells
+     * the fill has combined at least one pair of shorter cells into (the cells of single
+     * symbols are only seeded with the terminals, they are never visited)
+     */
+    struct RecognitionStatistics {
+        double init_seconds = 0;
+        double fill_seconds = 0;
+        size_t chart_bytes = 0;
+        size_t cells_touched = 0;
+    };
+
+    struct Statistics {
+        std::optional<ConversionStatistics> conversion;
+        std::optional<RecognitionStatistics> recognition;
+    };
+
+    inline double getSecondsSince(StatisticsClock::time_point start) {
+        return std::chrono::duration<double>(StatisticsClock::now() - start).count();
+    }
+
+    // Prints the statistics as one JSON object, the missing parts are omitted
+    void printStatistics(std::ostream& out, const Statistics& stats);
+}  // namespace fl::algo
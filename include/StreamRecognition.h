@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace logic {
+    // A block is recognized once it is full or there is nothing more to read right away,
+    // so a slow producer gets its answers without waiting for the whole block
+    constexpr size_t kStreamBlockSize = 4096;
+
+    // The blocks read ahead while the current one is recognized,
+    // it bounds the memory for an input of any length
+    constexpr size_t kStreamQueuedBlocks = 2;
+
+    struct StreamBlock {
+        std::vector<std::string> records;
+        bool is_last{false};
+    };
+
+    /**
+     * StreamBlockQueue hands the blocks over from the reader to the recognition.
+     * push() waits while kStreamQueuedBlocks blocks are queued. Once the queue is closed,
+     * push() drops the block and returns false, so the reader stops when nobody pops anymore.
+     */
+    class StreamBlockQueue {
+    public:
+        bool push(StreamBlock&& block);
+        StreamBlock pop();
+        void close();
+
+    private:
+        std::deque<StreamBlock> m_blocks;
+        std::mutex m_mutex;
+        std::condition_variable m_not_full_cv;
+        std::condition_variable m_not_empty_cv;
+        bool m_is_closed{false};
+    };
+
+    /**
+     * Splits the input into the records ended by the delimiter (the last one may be not ended)
+     * and pushes them by blocks until the input ends or the queue is closed.
+     * The last block of the input is marked with is_last.
+     */
+    void readStreamBlocks(std::istream& in, char delimiter, StreamBlockQueue& queue);
+
+    /**
+     * Reads the records of the input in another thread, recognizes every block with the pool
+     * and writes "Yes" or "No" per record in the order of the input, the output is flushed after every block.
+     *
+     * If the recognition throws, the queue is closed and the reader is joined before
+     * the exception leaves, the reader still finishes the record it is waiting for.
+     */
+    void recognizeStream(std::istream& in,
+                         std::ostream& out,
+                         char delimiter,
+                         fl::algo::ThreadPool& pool,
+                         const std::function<bool(std::string_view text)>& recognize);
+}  // namespace logic
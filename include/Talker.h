@@ -10,13 +10,47 @@ namespace ui {
     constexpr const char* const std_help_string =
             "gc-cykp: Grammar Converter and CYK Parser\n"
             "USAGE:\n"
-            "   gc-cykp -C <phase_number> [-s <converted_grammar_file>] <grammar_file>\n"
-            "   gc-cykp -R <text_file> [-s <converted_grammar_file>] [-n] <grammar_file>\n"
+            "   gc-cykp -C <phase_number> [-s <converted_grammar_file>] [-b <compiled_grammar_file>] [-S <stats_file>] [-d <dump_directory>] <grammar_file>\n"
+            "   gc-cykp -R <text_file> [-s <converted_grammar_file>] [-b <compiled_grammar_file>] [-n] [-t] [-f] [-p] [-w <semiring>] [-F <forest_file>] [-T] [-S <stats_file>] [-d <dump_directory>] [-j <threads_count>] [-e <engine>] [-k <kernel>] <grammar_file>\n"
+            "   gc-cykp -B <batch_path> [-c] [-s <converted_grammar_file>] [-b <compiled_grammar_file>] [-S <stats_file>] [-d <dump_directory>] [-n] [-t] [-f] [-j <threads_count>] [-e <engine>] [-k <kernel>] <grammar_file>\n"
+            "   gc-cykp -I [-0] [-s <converted_grammar_file>] [-b <compiled_grammar_file>] [-S <stats_file>] [-d <dump_directory>] [-n] [-t] [-f] [-j <threads_count>] [-e <engine>] [-k <kernel>] <grammar_file>\n"
             "OPTIONS:\n"
             "   -R - recognition mode\n"
             "       -n - do not convert a grammar, the grammar must be already in the Chomsky form\n"
-            "   -C - convertation only mode\n"
-            "   -s - save a converted grammar in a <converted_grammar_file>\n";
+            "       -t - split the text into the longest terminals first and recognize the tokens\n"
+            "       -f - keep in the \"cyk\" chart only the nonterminals predicted by the text before them\n"
+            "       -p - also report the longest prefix of the text that can be completed to a sentence,\n"
+            "            the characters are the symbols then, so it can't be combined with -t\n"
+            "       -w - also evaluate the text over a semiring: \"count\" - the number of the derivations\n"
+            "            by the grammar as written, \"best\" - the smallest sum of the {weight} annotations\n"
+            "            of a derivation, it requires -n or a compiled grammar\n"
+            "       -F - save the shared packed parse forest of the text in a <forest_file>,\n"
+            "            one line per node: <node> <nonterminal> <begin> <end> : <family> | ...\n"
+            "       -T - also print one parse tree of the text\n"
+            "       -j - the number of threads for the recognition, 1 by default\n"
+            "       -e - the recognition engine: \"cyk\" (default), \"valiant\" or \"earley\",\n"
+            "            \"earley\" works on the grammar as it is, without the conversion\n"
+            "       -k - the matrix product kernel of the \"valiant\" engine: \"naive\" (default) or \"4r\"\n"
+            "   -B - batch recognition mode, prints \"<input>\\t<Yes|No>\" for every input\n"
+            "       <batch_path> is a directory of texts or a file with one text path per line,\n"
+            "       relative to the directory of that file\n"
+            "       -c - <batch_path> is a corpus, every line of it is a separate text\n"
+            "       -j - the number of texts recognized in parallel, 1 by default\n"
+            "   -I - stream recognition mode, every line of the standard input is a separate text,\n"
+            "        \"<Yes|No>\" is printed for every line in the same order\n"
+            "       -0 - the texts are separated by the NUL characters instead of the line ends\n"
+            "       -j - the number of texts recognized in parallel, 1 by default\n"
+            "   -C - convertation only mode, the conversion stops after the phase <phase_number>,\n"
+            "        0 runs all of them: 1 - useless nonterminals, 2 - mixed and long rules,\n"
+            "        3 - empty rules, 4 - chain rules, 5 - the nonterminals made useless\n"
+            "   -s - save a converted grammar in a <converted_grammar_file>\n"
+            "   -b - save a compiled binary grammar in a <compiled_grammar_file>,\n"
+            "        -R, -B and -I accept such a file instead of a <grammar_file> and skip the conversion\n"
+            "   -S - save the time and the sizes of every conversion pass in a <stats_file> as JSON,\n"
+            "        with -R and the \"cyk\" engine also the time, the chart size and the filled cells\n"
+            "        of the recognition\n"
+            "   -d - save the grammar after every conversion pass in the <dump_directory>,\n"
+            "        the files are named <pass_number>_<pass_name>.txt\n";
 
     constexpr const char* const std_term_string = "The program has interrupted its execution: ";
     
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fl::algo {
+    struct CompiledGrammarSerializer;
+
+    /**
+     * TerminalMatcher is an Aho-Corasick automaton over the terminal strings of a grammar.
+     * Every pattern is a distinct non-empty terminal together with the codes of
+     * all the nonterminals that have a terminal rule with it.
+     *
+     * One scan of a text reports every occurrence of every terminal.
+     */
+    class TerminalMatcher {
+    public:
+        using State = uint32_t;
+
+        static constexpr State kNoState = std::numeric_limits<State>::max();
+
+        struct Pattern {
+            size_t length;
+            size_t nt_codes_begin;
+            size_t nt_codes_end;
+        };
+
+        void clear() noexcept;
+        void addPattern(const std::string& terminal, size_t nt_code);
+
+        // Must be called after all the patterns are added
+        void build();
+
+        [[nodiscard]] bool empty() const noexcept { return m_patterns.empty(); }
+        [[nodiscard]] static State root() noexcept { return 0; }
+
+        // The trie edge from the state by ch, or kNoState
+        [[nodiscard]] State child(State state, char ch) const noexcept;
+
+        // The automaton transition, it follows the failure links when there is no trie edge
+        [[nodiscard]] State next(State state, char ch) const noexcept;
+
+        /**
+         * Calls f(length, nt_code) for every terminal that ends in the state,
+         * i.e. for every suffix of the consumed text that is a terminal
+         */
+        template <typename F>
+        void forEachMatch(State state, F&& f) const {
+            if (m_nodes[state].pattern == kNoPattern) {
+                state = m_nodes[state].output;
+            }
+
+            while (state != kNoState) {
+                const auto& pattern = m_patterns[m_nodes[state].pattern];
+
+                for (size_t i = pattern.nt_codes_begin; i < pattern.nt_codes_end; ++i) {
+                    f(pattern.length, m_nt_codes[i]);
+                }
+
+                state = m_nodes[state].output;
+            }
+        }
+
+        /**
+         * Calls f(length, nt_code) for the terminal that is equal to the whole path
+         * from the root to the state, if there is one
+         */
+        template <typename F>
+        void forEachExactMatch(State state, F&& f) const {
+            if (m_nodes[state].pattern == kNoPattern) {
+                return;
+            }
+
+            const auto& pattern = m_patterns[m_nodes[state].pattern];
+
+            for (size_t i = pattern.nt_codes_begin; i < pattern.nt_codes_end; ++i) {
+                f(pattern.length, m_nt_codes[i]);
+            }
+        }
+
+        /**
+         * Calls f(nt_code) once for every nonterminal having a terminal rule
+         * that starts with the whole path from the root to the state
+         */
+        template <typename F>
+        void forEachPrefixMatch(State state, F&& f) const {
+            const auto& node = m_nodes[state];
+
+            for (size_t i = node.prefix_nt_codes_begin; i < node.prefix_nt_codes_end; ++i) {
+                f(m_prefix_nt_codes[i]);
+            }
+        }
+
+        /**
+         * Calls f(pos, len, nt_code) for every occurrence of every terminal,
+         * text[pos:pos + len] is the terminal
+         */
+        template <typename F>
+        void findMatches(std::string_view text, F&& f) const {
+            if (empty()) {
+                return;
+            }
+
+            State state = root();
+
+            for (size_t end = 1; end <= text.size(); ++end) {
+                state = next(state, text[end - 1]);
+
+                forEachMatch(state, [&](size_t len, size_t nt_code) {
+                    f(end - len, len, nt_code);
+                });
+            }
+        }
+
+    private:
+        // Dumps and restores the flat arrays of the automaton, see CompiledGrammarFile.h
+        friend struct CompiledGrammarSerializer;
+
+        static constexpr size_t kNoPattern = std::numeric_limits<size_t>::max();
+
+        struct Node {
+            size_t edges_begin{0};
+            size_t edges_end{0};
+            size_t pattern{kNoPattern};
+            State fail{0};
+            State output{kNoState};  // the closest state on the failure chain with a pattern
+            size_t prefix_nt_codes_begin{0};
+            size_t prefix_nt_codes_end{0};
+        };
+
+        struct Edge {
+            char ch;
+            State target;
+        };
+
+        // (terminal, nt_code) pairs collected before build()
+        std::vector<std::pair<std::string, size_t>> m_pending;
+
+        std::vector<Node> m_nodes;
+        std::vector<Edge> m_edges;
+        std::vector<Pattern> m_patterns;
+        std::vector<size_t> m_nt_codes;
+        std::vector<size_t> m_prefix_nt_codes;
+    };
+}  // namespace fl::algo
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace fl::algo {
+    /**
+     * ThreadPool keeps a fixed number of worker threads that execute submitted tasks.
+     * The pool with threads_count == 1 has no workers at all and runs everything
+     * in the calling thread.
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+        using RangeTask = std::function<void(size_t begin, size_t end)>;
+
+        explicit ThreadPool(size_t threads_count);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool();
+
+        [[nodiscard]] size_t size() const noexcept { return m_workers.size() + 1; }
+
+        void submit(Task task);
+        void wait();
+
+        /**
+         * Splits [0, count) into contiguous chunks of at least min_chunk elements,
+         * runs task(begin, end) for every chunk and waits for all of them
+         */
+        void parallelFor(size_t count, size_t min_chunk, const RangeTask& task);
+
+    private:
+        void workerLoop();
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::queue<Task> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_task_cv;
+        std::condition_variable m_done_cv;
+        size_t m_active_count{0};
+        bool m_is_stopped{false};
+    };
+}  // namespace fl::algo
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+#include "RecognitionOptions.h"
+
+#include <string_view>
+
+namespace fl::algo::valiant {
+    /**
+     * Recognizes the text the same way as cyk::isRecognized does, but reduces
+     * filling of the chart to boolean matrix products following Valiant's
+     * divide-and-conquer algorithm (in the form given by A. Okhotin).
+     */
+    bool isRecognized(std::string_view text,
+                      const CompiledGrammar& cg,
+                      const RecognitionOptions& options = {});
+}  // namespace fl::algo::valiant
@@ -4,6 +4,7 @@
 #include "ParsedArguments.h"
 
 #include <filesystem>
+#include <fstream>
 
 namespace logic {
     Application::Application()
@@ -30,11 +31,57 @@ namespace logic {
             preparePath(*pargs.text_filename, "text path");
         }
 
-        if (pargs.converted_grammar_filename.has_value()) {
-            if (!exists(pargs.converted_grammar_filename->parent_path())) {
-                m_exceptor.sendException("The save directory for the converted grammar doesn't exist");
+        if (pargs.batch_path.has_value()) {
+            if (!exists(*pargs.batch_path)) {
+                m_exceptor.sendException("The batch path doesn't exist.\n");
+            }
+
+            if (pargs.is_batch_corpus) {
+                preparePath(*pargs.batch_path, "corpus path");
+            } else if (!is_directory(*pargs.batch_path) && !is_regular_file(*pargs.batch_path)) {
+                m_exceptor.sendException("The batch path is neither a directory nor a regular file.\n");
             }
         }
+
+        auto prepareSavePath = [this](const path& p, const std::string& file_name) {
+            if (p.has_parent_path() && !exists(p.parent_path())) {
+                m_exceptor.sendException("The save directory for the " + file_name + " doesn't exist.\n");
+            }
+        };
+
+        if (pargs.converted_grammar_filename.has_value()) {
+            prepareSavePath(*pargs.converted_grammar_filename, "converted grammar");
+        }
+
+        if (pargs.compiled_grammar_filename.has_value()) {
+            prepareSavePath(*pargs.compiled_grammar_filename, "compiled grammar");
+        }
+
+        if (pargs.forest_filename.has_value()) {
+            prepareSavePath(*pargs.forest_filename, "parse forest");
+        }
+
+        if (pargs.stats_filename.has_value()) {
+            prepareSavePath(*pargs.stats_filename, "statistics");
+        }
+
+        if (pargs.dump_directory.has_value() && !is_directory(*pargs.dump_directory)) {
+            m_exceptor.sendException("The dump directory doesn't exist.\n");
+        }
+    }
+
+    void Application::saveStatistics(const ui::ParsedArguments& pargs) {
+        if (!pargs.stats_filename) {
+            return;
+        }
+
+        std::ofstream fout(*pargs.stats_filename);
+
+        if (!fout.good()) {
+            m_exceptor.sendException("failed to open the file for statistics.\n");
+        }
+
+        fl::algo::printStatistics(fout, m_statistics);
     }
 
     int Application::exec(int argc, char** argv) {
@@ -57,8 +104,16 @@ namespace logic {
             case ProgramMode::kRecognition:
                 execRecognition(pargs);
                 break;
+            case ProgramMode::kBatchRecognition:
+                execBatchRecognition(pargs);
+                break;
+            case ProgramMode::kStreamRecognition:
+                execStreamRecognition(pargs);
+                break;
         }
 
+        saveStatistics(pargs);
+
         return 0;
     }
 }  // namespace logic
\ No newline at end of file
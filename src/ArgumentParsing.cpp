@@ -22,6 +22,7 @@ namespace ui {
             return flag[1] == '\0' || flag[2] == '\0';
         };
         ParsedArguments pargs;
+        bool is_recognition_requested = false;
 
         for (int i = 1; i < argc; ++i) {
             const char* arg = argv[i];
@@ -55,6 +56,7 @@ namespace ui {
 
                 case 'R': {
                     pargs.mode = ProgramMode::kRecognition;
+                    is_recognition_requested = true;
                     ++i;
 
                     if (argument_exists(i) && !is_argument_flag(i)) {
@@ -71,11 +73,117 @@ namespace ui {
                     break;
                 }
 
+                case 'B': {
+                    pargs.mode = ProgramMode::kBatchRecognition;
+                    is_recognition_requested = true;
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        try {
+                            pargs.batch_path = argv[i];
+                        }
+                        catch (...) {
+                            exceptor.sendException("Failed to assign a batch path to std::filesystem::path.\n");
+                        }
+                    } else {
+                        exceptor.sendException("Expected a path after the '-B' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'c': {
+                    pargs.is_batch_corpus = true;
+                    break;
+                }
+
+                case 'I': {
+                    pargs.mode = ProgramMode::kStreamRecognition;
+                    is_recognition_requested = true;
+                    break;
+                }
+
+                case '0': {
+                    pargs.is_nul_separated = true;
+                    break;
+                }
+
                 case 'n': {
                     pargs.is_already_converted = true;
                     break;
                 }
 
+                case 't': {
+                    pargs.is_token_level = true;
+                    break;
+                }
+
+                case 'f': {
+                    pargs.is_prediction_filtered = true;
+                    break;
+                }
+
+                case 'p': {
+                    pargs.need_viable_prefix = true;
+                    break;
+                }
+
+                case 'T': {
+                    pargs.need_parse_tree = true;
+                    break;
+                }
+
+                case 'F': {
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        try {
+                            pargs.forest_filename = argv[i];
+                        }
+                        catch (...) {
+                            exceptor.sendException("Failed to assign a parse forest path to std::filesystem::path.\n");
+                        }
+                    } else {
+                        exceptor.sendException("Expected a path after the '-F' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'S': {
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        try {
+                            pargs.stats_filename = argv[i];
+                        }
+                        catch (...) {
+                            exceptor.sendException("Failed to assign a statistics path to std::filesystem::path.\n");
+                        }
+                    } else {
+                        exceptor.sendException("Expected a path after the '-S' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'd': {
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        try {
+                            pargs.dump_directory = argv[i];
+                        }
+                        catch (...) {
+                            exceptor.sendException("Failed to assign a dump directory to std::filesystem::path.\n");
+                        }
+                    } else {
+                        exceptor.sendException("Expected a directory after the '-d' flag.\n");
+                    }
+
+                    break;
+                }
+
                 case 'C': {
                     pargs.mode = ProgramMode::kConversion;
                     ++i;
@@ -94,6 +202,83 @@ namespace ui {
                     break;
                 }
 
+                case 'j': {
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        int threads_count = std::stoi(argv[i]);
+
+                        if (threads_count <= 0) {
+                            exceptor.sendException("Expected a positive number after the '-j' flag.\n");
+                        }
+
+                        pargs.threads_count = static_cast<size_t>(threads_count);
+                    } else {
+                        exceptor.sendException("Expected a number of threads after the '-j' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'e': {
+                    using RecognitionEngine = ui::ParsedArguments::RecognitionEngine;
+                    ++i;
+
+                    if (!argument_exists(i) || is_argument_flag(i)) {
+                        exceptor.sendException("Expected an engine name after the '-e' flag.\n");
+                    }
+
+                    if (std::strcmp(argv[i], "cyk") == 0) {
+                        pargs.engine = RecognitionEngine::kCYK;
+                    } else if (std::strcmp(argv[i], "valiant") == 0) {
+                        pargs.engine = RecognitionEngine::kValiant;
+                    } else if (std::strcmp(argv[i], "earley") == 0) {
+                        pargs.engine = RecognitionEngine::kEarley;
+                    } else {
+                        exceptor.sendException("Unknown recognition engine after the '-e' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'k': {
+                    using ProductKernel = ui::ParsedArguments::ProductKernel;
+                    ++i;
+
+                    if (!argument_exists(i) || is_argument_flag(i)) {
+                        exceptor.sendException("Expected a kernel name after the '-k' flag.\n");
+                    }
+
+                    if (std::strcmp(argv[i], "naive") == 0) {
+                        pargs.kernel = ProductKernel::kNaive;
+                    } else if (std::strcmp(argv[i], "4r") == 0) {
+                        pargs.kernel = ProductKernel::kFourRussians;
+                    } else {
+                        exceptor.sendException("Unknown matrix product kernel after the '-k' flag.\n");
+                    }
+
+                    break;
+                }
+
+                case 'w': {
+                    using WeightSemiring = ui::ParsedArguments::WeightSemiring;
+                    ++i;
+
+                    if (!argument_exists(i) || is_argument_flag(i)) {
+                        exceptor.sendException("Expected a semiring name after the '-w' flag.\n");
+                    }
+
+                    if (std::strcmp(argv[i], "count") == 0) {
+                        pargs.semiring = WeightSemiring::kCount;
+                    } else if (std::strcmp(argv[i], "best") == 0) {
+                        pargs.semiring = WeightSemiring::kBest;
+                    } else {
+                        exceptor.sendException("Unknown semiring after the '-w' flag.\n");
+                    }
+
+                    break;
+                }
+
                 case 's': {
                     ++i;
 
@@ -111,13 +296,44 @@ namespace ui {
                     break;
                 }
 
+                case 'b': {
+                    ++i;
+
+                    if (argument_exists(i) && !is_argument_flag(i)) {
+                        try {
+                            pargs.compiled_grammar_filename = argv[i];
+                        }
+                        catch (...) {
+                            exceptor.sendException("Failed to assign a compiled grammar path to std::filesystem::path.\n");
+                        }
+                    } else {
+                        exceptor.sendException("Expected a path after the '-b' flag.\n");
+                    }
+
+                    break;
+                }
+
                 default: {
                     exceptor.sendException("Got unexpected flag in the arguments.\n");
                     break;
                 }
             }
         }
-        
+
+        // A partially converted grammar can't be recognized with
+        if (pargs.conversion_end_phase && is_recognition_requested) {
+            exceptor.sendException("The '-C' flag can't be combined with the '-R', '-B' and '-I' flags.\n");
+        }
+
+        // A batch and a stream only report whether every input is recognized
+        if (pargs.need_viable_prefix || pargs.semiring || pargs.forest_filename || pargs.need_parse_tree) {
+            if (pargs.mode == ProgramMode::kBatchRecognition) {
+                exceptor.sendException("The '-B' flag can't be combined with the '-p', '-w', '-F' and '-T' flags.\n");
+            } else if (pargs.mode == ProgramMode::kStreamRecognition) {
+                exceptor.sendException("The '-I' flag can't be combined with the '-p', '-w', '-F' and '-T' flags.\n");
+            }
+        }
+
         return pargs;
     }
 }  // namespace ui
\ No newline at end of file
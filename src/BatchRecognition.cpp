@@ -0,0 +1,129 @@
+#include "BatchRecognition.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+#include "MappedFile.h"
+
+namespace {
+    enum class BatchResult : char {
+        kNo,
+        kYes,
+        kUnreadable
+    };
+}  // namespace
+
+namespace logic {
+    BatchReader::BatchReader(const std::filesystem::path& batch_path, bool is_corpus)
+        : m_is_corpus(is_corpus) {
+        namespace fs = std::filesystem;
+
+        if (fs::is_directory(batch_path)) {
+            for (const auto& entry : fs::directory_iterator(batch_path)) {
+                if (entry.is_regular_file()) {
+                    m_directory_files.push_back(entry.path().string());
+                }
+            }
+
+            std::sort(m_directory_files.begin(), m_directory_files.end());
+            return;
+        }
+
+        m_list_fin.open(batch_path);
+
+        if (!m_list_fin.good()) {
+            throw std::runtime_error("failed to open the batch file.\n");
+        }
+
+        m_list_directory = batch_path.parent_path();
+    }
+
+    bool BatchReader::readBlock(std::vector<BatchInput>& block) {
+        block.clear();
+
+        while (block.size() < kBatchBlockSize) {
+            if (m_list_fin.is_open()) {
+                std::string line;
+
+                if (!std::getline(m_list_fin, line)) {
+                    break;
+                }
+
+                ++m_line_number;
+
+                if (m_is_corpus) {
+                    block.push_back({std::to_string(m_line_number), std::move(line)});
+                } else if (!line.empty()) {
+                    // The paths of a list are relative to the list itself, not to the working directory
+                    const std::filesystem::path path = m_list_directory / line;
+                    block.push_back({line, path.string()});
+                }
+            } else {
+                if (m_next_file == m_directory_files.size()) {
+                    break;
+                }
+
+                block.push_back({m_directory_files[m_next_file], m_directory_files[m_next_file]});
+                ++m_next_file;
+            }
+        }
+
+        return !block.empty();
+    }
+
+    void recognizeBatch(BatchReader& reader,
+                        fl::algo::ThreadPool& pool,
+                        std::ostream& out,
+                        const std::function<bool(std::string_view text)>& recognize) {
+        std::vector<BatchInput> block;
+        std::vector<BatchResult> results;
+
+        while (reader.readBlock(block)) {
+            results.assign(block.size(), BatchResult::kNo);
+
+            // One task per input: the texts may differ in length a lot,
+            // so the free workers simply take the next one
+            for (size_t i = 0; i < block.size(); ++i) {
+                pool.submit([&, i] {
+                    if (reader.isCorpus()) {
+                        results[i] = recognize(block[i].data) ? BatchResult::kYes : BatchResult::kNo;
+                        return;
+                    }
+
+                    std::optional<fl::TextInput> text_input;
+
+                    try {
+                        text_input.emplace(block[i].data);
+                    }
+                    catch (std::exception&) {
+                        results[i] = BatchResult::kUnreadable;
+                        return;
+                    }
+
+                    results[i] = recognize(text_input->view()) ? BatchResult::kYes : BatchResult::kNo;
+                });
+            }
+
+            pool.wait();
+
+            for (size_t i = 0; i < block.size(); ++i) {
+                out << block[i].name << '\t';
+
+                switch (results[i]) {
+                    case BatchResult::kNo:
+                        out << "No\n";
+                        break;
+                    case BatchResult::kYes:
+                        out << "Yes\n";
+                        break;
+                    case BatchResult::kUnreadable:
+                        out << "Failed to read\n";
+                        break;
+                }
+            }
+        }
+
+        out.flush();
+    }
+}  // namespace logic
@@ -0,0 +1,258 @@
+#include "BitKernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define FL_HAS_X86_KERNELS 1
+    #include <immintrin.h>
+#else
+    #define FL_HAS_X86_KERNELS 0
+#endif
+
+namespace {
+    using namespace fl::algo;
+
+    void orWordsScalar(uint64_t* dst, const uint64_t* src, size_t words) noexcept {
+        for (size_t w = 0; w < words; ++w) {
+            dst[w] |= src[w];
+        }
+    }
+
+    bool intersectsScalar(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        uint64_t acc = 0;
+
+        for (size_t w = 0; w < words; ++w) {
+            acc |= a[w] & b[w];
+        }
+
+        return acc != 0;
+    }
+
+    bool andWordsScalar(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        uint64_t acc = 0;
+
+        for (size_t w = 0; w < words; ++w) {
+            dst[w] = a[w] & b[w];
+            acc |= dst[w];
+        }
+
+        return acc != 0;
+    }
+
+    bool isEmptyScalar(const uint64_t* a, size_t words) noexcept {
+        uint64_t acc = 0;
+
+        for (size_t w = 0; w < words; ++w) {
+            acc |= a[w];
+        }
+
+        return acc == 0;
+    }
+
+    bool coversScalar(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        uint64_t acc = 0;
+
+        for (size_t w = 0; w < words; ++w) {
+            acc |= b[w] & ~a[w];
+        }
+
+        return acc == 0;
+    }
+
+    constexpr BitKernels kScalarKernels{orWordsScalar,
+                                        intersectsScalar,
+                                        andWordsScalar,
+                                        isEmptyScalar,
+                                        coversScalar,
+                                        SimdLevel::kScalar};
+
+#if FL_HAS_X86_KERNELS
+    // The chart cells are not necessarily aligned to the vector size, so the loads are unaligned.
+    // The tails shorter than a vector are left to the scalar loops.
+
+    __attribute__((target("avx2")))
+    void orWordsAVX2(uint64_t* dst, const uint64_t* src, size_t words) noexcept {
+        size_t w = 0;
+
+        for (; w + 4 <= words; w += 4) {
+            auto* d = reinterpret_cast<__m256i*>(dst + w);
+            const auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w));
+            _mm256_storeu_si256(d, _mm256_or_si256(_mm256_loadu_si256(d), s));
+        }
+
+        orWordsScalar(dst + w, src + w, words - w);
+    }
+
+    __attribute__((target("avx2")))
+    bool intersectsAVX2(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; w + 4 <= words; w += 4) {
+            const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+            const auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+            acc = _mm256_or_si256(acc, _mm256_and_si256(x, y));
+        }
+
+        return !_mm256_testz_si256(acc, acc) || intersectsScalar(a + w, b + w, words - w);
+    }
+
+    __attribute__((target("avx2")))
+    bool andWordsAVX2(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; w + 4 <= words; w += 4) {
+            const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+            const auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+            const auto z = _mm256_and_si256(x, y);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w), z);
+            acc = _mm256_or_si256(acc, z);
+        }
+
+        // The tail is computed in any case, the result must be complete
+        const bool has_tail_bits = andWordsScalar(dst + w, a + w, b + w, words - w);
+
+        return !_mm256_testz_si256(acc, acc) || has_tail_bits;
+    }
+
+    __attribute__((target("avx2")))
+    bool isEmptyAVX2(const uint64_t* a, size_t words) noexcept {
+        size_t w = 0;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; w + 4 <= words; w += 4) {
+            acc = _mm256_or_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w)));
+        }
+
+        return _mm256_testz_si256(acc, acc) && isEmptyScalar(a + w, words - w);
+    }
+
+    __attribute__((target("avx2")))
+    bool coversAVX2(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; w + 4 <= words; w += 4) {
+            const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+            const auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+            acc = _mm256_or_si256(acc, _mm256_andnot_si256(x, y));
+        }
+
+        return _mm256_testz_si256(acc, acc) && coversScalar(a + w, b + w, words - w);
+    }
+
+    __attribute__((target("avx512f")))
+    void orWordsAVX512(uint64_t* dst, const uint64_t* src, size_t words) noexcept {
+        size_t w = 0;
+
+        for (; w + 8 <= words; w += 8) {
+            const auto d = _mm512_loadu_si512(dst + w);
+            _mm512_storeu_si512(dst + w, _mm512_or_si512(d, _mm512_loadu_si512(src + w)));
+        }
+
+        orWordsScalar(dst + w, src + w, words - w);
+    }
+
+    __attribute__((target("avx512f")))
+    bool intersectsAVX512(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m512i acc = _mm512_setzero_si512();
+
+        for (; w + 8 <= words; w += 8) {
+            acc = _mm512_or_si512(acc, _mm512_and_si512(_mm512_loadu_si512(a + w), _mm512_loadu_si512(b + w)));
+        }
+
+        return _mm512_test_epi64_mask(acc, acc) != 0 || intersectsScalar(a + w, b + w, words - w);
+    }
+
+    __attribute__((target("avx512f")))
+    bool andWordsAVX512(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m512i acc = _mm512_setzero_si512();
+
+        for (; w + 8 <= words; w += 8) {
+            const auto z = _mm512_and_si512(_mm512_loadu_si512(a + w), _mm512_loadu_si512(b + w));
+            _mm512_storeu_si512(dst + w, z);
+            acc = _mm512_or_si512(acc, z);
+        }
+
+        const bool has_tail_bits = andWordsScalar(dst + w, a + w, b + w, words - w);
+
+        return _mm512_test_epi64_mask(acc, acc) != 0 || has_tail_bits;
+    }
+
+    __attribute__((target("avx512f")))
+    bool isEmptyAVX512(const uint64_t* a, size_t words) noexcept {
+        size_t w = 0;
+        __m512i acc = _mm512_setzero_si512();
+
+        for (; w + 8 <= words; w += 8) {
+            acc = _mm512_or_si512(acc, _mm512_loadu_si512(a + w));
+        }
+
+        return _mm512_test_epi64_mask(acc, acc) == 0 && isEmptyScalar(a + w, words - w);
+    }
+
+    __attribute__((target("avx512f")))
+    bool coversAVX512(const uint64_t* a, const uint64_t* b, size_t words) noexcept {
+        size_t w = 0;
+        __m512i acc = _mm512_setzero_si512();
+
+        for (; w + 8 <= words; w += 8) {
+            acc = _mm512_or_si512(acc, _mm512_andnot_si512(_mm512_loadu_si512(a + w), _mm512_loadu_si512(b + w)));
+        }
+
+        return _mm512_test_epi64_mask(acc, acc) == 0 && coversScalar(a + w, b + w, words - w);
+    }
+
+    constexpr BitKernels kAVX2Kernels{orWordsAVX2,
+                                      intersectsAVX2,
+                                      andWordsAVX2,
+                                      isEmptyAVX2,
+                                      coversAVX2,
+                                      SimdLevel::kAVX2};
+    constexpr BitKernels kAVX512Kernels{orWordsAVX512,
+                                        intersectsAVX512,
+                                        andWordsAVX512,
+                                        isEmptyAVX512,
+                                        coversAVX512,
+                                        SimdLevel::kAVX512};
+#endif
+}  // namespace
+
+namespace fl::algo {
+    SimdLevel detectSimdLevel() noexcept {
+#if FL_HAS_X86_KERNELS
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::kAVX512;
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::kAVX2;
+        }
+#endif
+        return SimdLevel::kScalar;
+    }
+
+    const BitKernels& getBitKernels(SimdLevel level) noexcept {
+#if FL_HAS_X86_KERNELS
+        switch (level) {
+            case SimdLevel::kAVX512:
+                return kAVX512Kernels;
+            case SimdLevel::kAVX2:
+                return kAVX2Kernels;
+            case SimdLevel::kScalar:
+                break;
+        }
+#else
+        (void) level;
+#endif
+        return kScalarKernels;
+    }
+
+    const BitKernels& getBitKernels() noexcept {
+        static const BitKernels& kernels = getBitKernels(detectSimdLevel());
+        return kernels;
+    }
+}  // namespace fl::algo
@@ -0,0 +1,140 @@
+#include "BitMatrix.h"
+
+namespace {
+    using namespace fl::algo;
+
+    bool isTileEmpty(const BitTile& tile) noexcept {
+        BitWord acc = 0;
+
+        for (BitWord row : tile.rows) {
+            acc |= row;
+        }
+
+        return acc == 0;
+    }
+
+    void multiplyAddTile(BitTile& dst, const BitTile& a, const BitTile& b) noexcept {
+        for (size_t r = 0; r < kBitTileSize; ++r) {
+            BitWord acc = dst.rows[r];
+
+            for (BitWord bits = a.rows[r]; bits != 0; bits &= bits - 1) {
+                acc |= b.rows[__builtin_ctzll(bits)];
+            }
+
+            dst.rows[r] = acc;
+        }
+    }
+}  // namespace
+
+namespace fl::algo {
+    void transposeTile(BitTile& dst, const BitTile& src) noexcept {
+        dst = src;
+
+        // The off-diagonal blocks are swapped for every block size from 32 down to 1,
+        // so every block ends up transposed
+        BitWord mask = 0x00000000FFFFFFFFull;
+
+        for (size_t width = kBitTileSize / 2; width != 0; width >>= 1, mask ^= mask << width) {
+            for (size_t r = 0; r < kBitTileSize; r = (r + width + 1) & ~width) {
+                const BitWord diff = ((dst.rows[r] >> width) ^ dst.rows[r + width]) & mask;
+                dst.rows[r] ^= diff << width;
+                dst.rows[r + width] ^= diff;
+            }
+        }
+    }
+
+    TriangularBitMatrix::TriangularBitMatrix(size_t tiles_count)
+        : m_tiles_count(tiles_count)
+        , m_tiles(tiles_count * (tiles_count + 1) / 2, BitTile{}) {
+    }
+
+    void orRegion(TriangularBitMatrix& dst, const TriangularBitMatrix& src, BitRange rows, BitRange cols) noexcept {
+        for (size_t J = cols.begin; J < cols.end; ++J) {
+            for (size_t I = rows.begin; I < rows.end; ++I) {
+                BitTile& dst_tile = dst.tile(I, J);
+                const BitTile& src_tile = src.tile(I, J);
+
+                for (size_t r = 0; r < kBitTileSize; ++r) {
+                    dst_tile.rows[r] |= src_tile.rows[r];
+                }
+            }
+        }
+    }
+
+    void clearRegion(TriangularBitMatrix& dst, BitRange rows, BitRange cols) noexcept {
+        for (size_t J = cols.begin; J < cols.end; ++J) {
+            for (size_t I = rows.begin; I < rows.end; ++I) {
+                dst.tile(I, J) = BitTile{};
+            }
+        }
+    }
+
+    void multiplyAdd(TriangularBitMatrix& dst,
+                     const TriangularBitMatrix& a,
+                     const TriangularBitMatrix& b,
+                     BitRange rows,
+                     BitRange mids,
+                     BitRange cols) {
+        for (size_t K = cols.begin; K < cols.end; ++K) {
+            for (size_t J = mids.begin; J < mids.end; ++J) {
+                const BitTile& b_tile = b.tile(J, K);
+
+                if (isTileEmpty(b_tile)) {
+                    continue;
+                }
+
+                for (size_t I = rows.begin; I < rows.end; ++I) {
+                    multiplyAddTile(dst.tile(I, K), a.tile(I, J), b_tile);
+                }
+            }
+        }
+    }
+
+    void multiplyAddFourRussians(TriangularBitMatrix& dst,
+                                 const TriangularBitMatrix& a,
+                                 const TriangularBitMatrix& b,
+                                 BitRange rows,
+                                 BitRange mids,
+                                 BitRange cols) {
+        static const size_t kGroupBits = 8;
+        static const size_t kGroupsCount = kBitTileSize / kGroupBits;
+        static const size_t kEntriesCount = size_t{1} << kGroupBits;
+
+        // table[g * 256 + v] is the union of the rows of the group g of a tile of b selected by the bits of v
+        thread_local std::vector<BitWord> table(kGroupsCount * kEntriesCount);
+
+        for (size_t K = cols.begin; K < cols.end; ++K) {
+            for (size_t J = mids.begin; J < mids.end; ++J) {
+                const BitTile& b_tile = b.tile(J, K);
+
+                if (isTileEmpty(b_tile)) {
+                    continue;
+                }
+
+                for (size_t g = 0; g < kGroupsCount; ++g) {
+                    BitWord* entries = table.data() + g * kEntriesCount;
+                    entries[0] = 0;
+
+                    for (size_t v = 1; v < kEntriesCount; ++v) {
+                        entries[v] = entries[v & (v - 1)] | b_tile.rows[g * kGroupBits + __builtin_ctzll(v)];
+                    }
+                }
+
+                for (size_t I = rows.begin; I < rows.end; ++I) {
+                    const BitTile& a_tile = a.tile(I, J);
+                    BitTile& dst_tile = dst.tile(I, K);
+
+                    for (size_t r = 0; r < kBitTileSize; ++r) {
+                        BitWord acc = 0;
+
+                        for (BitWord bits = a_tile.rows[r], g = 0; bits != 0; bits >>= kGroupBits, ++g) {
+                            acc |= table[g * kEntriesCount + (bits & (kEntriesCount - 1))];
+                        }
+
+                        dst_tile.rows[r] |= acc;
+                    }
+                }
+            }
+        }
+    }
+}  // namespace fl::algo
@@ -1,111 +1,276 @@
 #include "CYK_Algorithm.h"
 
-#include "NonterminalCompression.h"
+#include "CYK_Chart.h"
+#include "BitMatrix.h"
+#include "Lexer.h"
+#include "Statistics.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <tuple>
 
 namespace {
     using namespace fl;
     using namespace fl::algo;
+    using namespace fl::algo::cyk;
+
+    // (pos, len, nt_code) of the symbol matches
+    using SymbolMatches = std::vector<std::tuple<size_t, size_t, size_t>>;
+
+    // Returns the number of the cells that got at least one pair of shorter cells combined into them
+    size_t fillCells(Chart& chart, size_t len, size_t pos_begin, size_t pos_end, CellCombiner& combiner) {
+        size_t visited_count = 0;
 
-    using SubstringVector = std::vector<std::vector<bool>>;
+        for (size_t pos = pos_begin; pos < pos_end; ++pos) {
+            ChartWord* cell = chart.cell(len, pos);
+            bool is_visited = false;
 
-    void initTerminalMultirulesVector(MultirulesMap& mm, const Grammar& g) {
-        for (const auto& [nt_index, multirrs] : g.multirules) {
-            for (const auto& rrs : multirrs) {
-                if (!rrs.nt_indexes.empty()) {
+            for (size_t k = 1; k < len; ++k) {
+                const ChartWord* left = chart.cell(k, pos);
+                const ChartWord* right = chart.cell(len - k, pos + k);
+
+                if (combiner.isEmpty(right)) {
                     continue;
                 }
 
-                mm[nt_index].push_back(rrs);
+                combiner.combine(cell, left, right);
+                is_visited = true;
+
+                if (combiner.isSaturated(cell)) {
+                    break;
+                }
             }
+
+            visited_count += is_visited;
         }
+
+        return visited_count;
     }
 
-    void initRecognitionVector(std::vector<SubstringVector>& v,
-                               const std::string& text,
-                               NonterminalTokenKeyTable& nt_table,
-                               const Grammar& g) {
-        MultirulesMap terminal_multirules;
-        std::string_view text_sv;
-        initTerminalMultirulesVector(terminal_multirules, g);
+    /**
+     * CYK with the top-down filter: predicted(pos) holds every A such that
+     * start =>* symbols[0:pos] A... (leftmost), and the cells starting at pos keep
+     * only the predicted nonterminals, the rest can never be a part of a derivation
+     * of the whole text.
+     *
+     * The chart is filled column by column: once all the cells ending at end are final,
+     * predicted(end) is the set of the right children C of the rules A -> BC
+     * with A in predicted(begin) and B in cell(begin, end), closed with leftDescendants().
+     * A cell with nothing predicted at its beginning stays empty, so it is not visited at all.
+     *
+     * Returns the number of the visited cells, the same way as fillCells
+     */
+    size_t fillPredictedChart(Chart& chart, SymbolMatches& matches, const CompiledGrammar& cg) {
+        const size_t n = chart.textSize();
+        const size_t cell_words = cg.nt_words;
+        const auto& kernels = getBitKernels();
+        const auto& left_descendants = cg.leftDescendants();
+        CellCombiner combiner(cg);
+        size_t visited_count = 0;
+
+        std::vector<ChartWord> predicted((n + 1) * cell_words, 0);
+        std::vector<ChartWord> right_children(cell_words);
+
+        auto predictedAt = [&](size_t pos) {
+            return predicted.data() + pos * cell_words;
+        };
+
+        kernels.or_words(predictedAt(0), left_descendants.data() + cg.start_code * cell_words, cell_words);
+
+        std::sort(matches.begin(), matches.end(), [](const auto& lhs, const auto& rhs) {
+            return std::get<0>(lhs) + std::get<1>(lhs) < std::get<0>(rhs) + std::get<1>(rhs);
+        });
+
+        auto match_it = matches.begin();
+
+        for (size_t end = 1; end <= n; ++end) {
+            for (; match_it != matches.end() && std::get<0>(*match_it) + std::get<1>(*match_it) == end; ++match_it) {
+                const auto& [pos, len, nt_code] = *match_it;
+
+                if (testBit(predictedAt(pos), nt_code)) {
+                    setBit(chart.cell(len, pos), nt_code);
+                }
+            }
+
+            // From the shortest cells of the column to the longest one
+            for (size_t begin = end - 1; begin-- > 0;) {
+                ChartWord* cell = chart.cell(end - begin, begin);
+                const ChartWord* mask = predictedAt(begin);
 
-        // There may be multiple terminals in one RuleRightSide
-        auto isTerminalRecognized = [&](std::string_view sv, const RuleRightSide& rrs) {
-            ssize_t pos = 0;
+                if (combiner.isEmpty(mask)) {
+                    continue;
+                }
+
+                bool is_visited = false;
+
+                for (size_t k = begin + 1; k < end; ++k) {
+                    const ChartWord* right = chart.cell(end - k, k);
+
+                    if (combiner.isEmpty(right)) {
+                        continue;
+                    }
 
-            for (auto t_key : rrs.sequence) {
-                auto& token = g.tntable.table.at(t_key).token;
+                    combiner.combine(cell, chart.cell(k - begin, begin), right);
+                    is_visited = true;
 
-                if (sv.substr(pos, token.size()) != token) {
-                    return false;
+                    if (combiner.isSaturated(cell)) {
+                        break;
+                    }
                 }
 
-                pos += static_cast<ssize_t>(token.size());
+                visited_count += is_visited;
+
+                for (size_t w = 0; w < cell_words; ++w) {
+                    cell[w] &= mask[w];
+                }
             }
 
-            return true;
-        };
+            if (end == n) {
+                return visited_count;
+            }
+
+            std::fill(right_children.begin(), right_children.end(), 0);
+
+            for (size_t begin = 0; begin < end; ++begin) {
+                const ChartWord* cell = chart.cell(end - begin, begin);
+                const ChartWord* mask = predictedAt(begin);
 
-        for (size_t len = 0; len <= text.size(); ++len) {
-            for (size_t pos = 0; pos + len <= text.size(); ++pos) {
-                for (const auto& [nt_code, multirrs] : terminal_multirules) {
-                    for (const auto& rrs : multirrs) {
-                        v[len][pos][nt_table[nt_code]] = isTerminalRecognized(text_sv.substr(pos, len), rrs);
+                for (size_t w = 0; w < cell_words; ++w) {
+                    for (ChartWord bits = cell[w]; bits != 0; bits &= bits - 1) {
+                        const size_t b_nt_code = w * kChartWordBits + __builtin_ctzll(bits);
 
-                        if (v[len][pos][nt_table[nt_code]]) {
-                            break;
+                        for (size_t p = cg.left_offsets[b_nt_code]; p < cg.left_offsets[b_nt_code + 1]; ++p) {
+                            const auto& pair = cg.pairs[p];
+
+                            for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                                if (testBit(mask, cg.heads[h])) {
+                                    setBit(right_children.data(), pair.right);
+                                    break;
+                                }
+                            }
                         }
                     }
                 }
             }
+
+            // predicted(end) may be empty inside a terminal of several characters,
+            // so it is not a sign of a dead prefix
+            ChartWord* next = predictedAt(end);
+
+            forEachBit(right_children.data(), {0, cg.nt_count}, [&](size_t c_nt_code) {
+                kernels.or_words(next, left_descendants.data() + c_nt_code * cell_words, cell_words);
+            });
         }
+
+        return visited_count;
+    }
+
+    // Returns the number of the visited cells, see fillCells
+    size_t fillSymbolsChart(Chart& chart, const SymbolMatches& matches, const CompiledGrammar& cg, size_t threads_count) {
+        // A chunk of a diagonal must be worth a task, otherwise short texts only pay for synchronisation
+        static const size_t kMinCellsPerTask = 32;
+
+        const size_t n = chart.textSize();
+
+        // chart.cell(length, position) has the bit nt_code set,
+        // if there is an output for the grammar to symbols[position:position + length]
+        // that starts from the nonterminal with nt_code
+        for (const auto& [pos, len, nt_code] : matches) {
+            setBit(chart.cell(len, pos), nt_code);
+        }
+
+        // All the cells of one length depend only on shorter ones,
+        // so every diagonal is split between the threads
+        std::unique_ptr<ThreadPool> pool;
+
+        if (threads_count > 1 && n > kMinCellsPerTask) {
+            pool = std::make_unique<ThreadPool>(threads_count);
+        }
+
+        CellCombiner combiner(cg);
+        std::atomic<size_t> visited_count{0};
+
+        for (size_t len = 2; len <= n; ++len) {
+            const size_t cells_count = n - len + 1;
+
+            if (!pool) {
+                visited_count += fillCells(chart, len, 0, cells_count, combiner);
+                continue;
+            }
+
+            pool->parallelFor(cells_count, kMinCellsPerTask, [&](size_t begin, size_t end) {
+                CellCombiner task_combiner(cg);
+                visited_count += fillCells(chart, len, begin, end, task_combiner);
+            });
+        }
+
+        return visited_count;
     }
 }  // namespace
 
 namespace fl::algo::cyk {
     // g must be in CNF
-    bool isRecognized(const std::string& text, const fl::Grammar& g) {
-        NonterminalTokenKeyTable nt_table;
-        initNonterminalTokenKeyTable(nt_table, g);
-        // is_recognized[length][position][nt_table[nt_code]] == true,
-        // if there is an output for the grammar to text[position:position + length]
-        // that starts from nt_code
-        std::vector<SubstringVector> is_recognized(text.size() + 1,
-                                                   SubstringVector(text.size(),
-                                                                   std::vector<bool>(g.tntable.nt_count, false)));
-        initRecognitionVector(is_recognized, text, nt_table, g);
-
-        size_t nt_code;
-        size_t a_nt_code;
-        size_t b_nt_code;
-
-        for (size_t len = 2; len <= text.size(); ++len) {
-            for (size_t pos = 0; pos + len <= text.size(); ++pos) {
-                for (const auto& [nt_key, multirrs] : g.multirules) {
-                    nt_code = nt_table[nt_key];
-
-                    for (const auto& rrs : multirrs) {
-                        if (rrs.nt_indexes.empty()) {
-                            continue;
-                        }
+    bool isRecognized(std::string_view text, const fl::Grammar& g) {
+        CompiledGrammar cg;
+        initCompiledGrammar(cg, g);
 
-                        // Here we depend on CNF. If there are nonterminals
-                        // in the rrs, then it's possible only and only when
-                        // the rule looks like A -> BC
-                        a_nt_code = nt_table[rrs.sequence[0]];
-                        b_nt_code = nt_table[rrs.sequence[1]];
-                        is_recognized[len][pos][nt_code] = is_recognized[len][pos][a_nt_code] &&
-                                is_recognized[0][pos][b_nt_code];
-
-                        for (size_t k = 0; !is_recognized[nt_code][len][pos] && k < len; ++k) {
-                            is_recognized[len][pos][nt_code] =
-                                    is_recognized[k][pos][a_nt_code] &&
-                                    is_recognized[len - k][pos + k][b_nt_code];
-                        }
-                    }
-                }
-            }
+        return isRecognized(text, cg);
+    }
+
+    bool isRecognized(std::string_view text, const CompiledGrammar& cg, const RecognitionOptions& options) {
+        if (cg.empty()) {
+            return false;
+        }
+
+        if (text.empty()) {
+            return cg.generates_empty;
+        }
+
+        const auto init_start = StatisticsClock::now();
+
+        // The symbols are the characters of the text or its tokens
+        SymbolMatches matches;
+        const auto symbols_count = findSymbolMatches(text, cg, options, [&](size_t pos, size_t len, size_t nt_code) {
+            matches.emplace_back(pos, len, nt_code);
+        });
+
+        if (!symbols_count) {
+            return false;
+        }
+
+        const size_t n = *symbols_count;
+
+        if (n == 0) {
+            return cg.generates_empty;
+        }
+
+        Chart chart(n, cg.nt_count);
+        const auto fill_start = StatisticsClock::now();
+
+        const size_t visited_count = options.is_prediction_filtered
+                                     ? fillPredictedChart(chart, matches, cg)
+                                     : fillSymbolsChart(chart, matches, cg, options.threads_count);
+
+        if (options.statistics) {
+            options.statistics->fill_seconds = getSecondsSince(fill_start);
+            options.statistics->init_seconds =
+                    std::chrono::duration<double>(fill_start - init_start).count();
+            options.statistics->chart_bytes = chart.bytes();
+            options.statistics->cells_touched = visited_count;
         }
 
-        return is_recognized[text.size()][0][nt_table[g.start]];
+        return testBit(chart.cell(n, 0), cg.start_code);
+    }
+
+    void fillChart(Chart& chart, std::string_view text, const CompiledGrammar& cg) {
+        SymbolMatches matches;
+
+        findTerminalMatches(text, cg, [&](size_t pos, size_t len, size_t nt_code) {
+            matches.emplace_back(pos, len, nt_code);
+        });
+
+        fillSymbolsChart(chart, matches, cg, 1);
     }
 }  // namespace fl::algo::cyk
@@ -0,0 +1,93 @@
+#include "CYK_Chart.h"
+
+#include "BitMatrix.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace fl::algo::cyk {
+    Chart::Chart(size_t text_size, size_t nt_count)
+        : m_text_size(text_size)
+        , m_cell_words((nt_count + kChartWordBits - 1) / kChartWordBits) {
+        // std::aligned_alloc requires the size to be a multiple of the alignment
+        size_t size = triangularCellsCount(text_size) * m_cell_words * sizeof(ChartWord);
+        size = (size + kChartAlignment - 1) / kChartAlignment * kChartAlignment;
+
+        if (size == 0) {
+            return;
+        }
+
+        auto* raw = static_cast<ChartWord*>(std::aligned_alloc(kChartAlignment, size));
+
+        if (raw == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        std::memset(raw, 0, size);
+        m_buffer.reset(raw);
+    }
+
+    size_t Chart::bytes() const noexcept {
+        return triangularCellsCount(m_text_size) * m_cell_words * sizeof(ChartWord);
+    }
+
+    void Chart::AlignedDeleter::operator()(ChartWord* p) const noexcept {
+        std::free(p);
+    }
+
+    CellCombiner::CellCombiner(const CompiledGrammar& cg)
+        : m_cg(cg)
+        , m_kernels(getBitKernels())
+        , m_cell_words(cg.nt_words)
+        , m_partners(cg.nt_words) {
+    }
+
+    void CellCombiner::combine(ChartWord* cell, const ChartWord* left, const ChartWord* right) noexcept {
+        const auto& pairs = m_cg.pairs;
+
+        auto addHeads = [&](const CompiledGrammar::RulePair& pair) {
+            for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                setBit(cell, m_cg.heads[h]);
+            }
+        };
+
+        for (size_t w = 0; w < m_cell_words; ++w) {
+            for (ChartWord bits = left[w]; bits != 0; bits &= bits - 1) {
+                const size_t b_nt_code = w * kChartWordBits + __builtin_ctzll(bits);
+                const size_t pairs_begin = m_cg.left_offsets[b_nt_code];
+                const size_t pairs_end = m_cg.left_offsets[b_nt_code + 1];
+                const size_t partner_row = m_cg.partner_rows[b_nt_code];
+
+                if (partner_row == kNoPartnerRow) {
+                    for (size_t p = pairs_begin; p < pairs_end; ++p) {
+                        if (testBit(right, pairs[p].right)) {
+                            addHeads(pairs[p]);
+                        }
+                    }
+
+                    continue;
+                }
+
+                const ChartWord* partners = m_cg.right_partners.data() + partner_row * m_cell_words;
+
+                if (!m_kernels.and_words(m_partners.data(), right, partners, m_cell_words)) {
+                    continue;
+                }
+
+                // The pairs of B are sorted by the right child, and every right child
+                // of the intersection has its pair, so the search only goes forward
+                auto pair_it = pairs.begin() + static_cast<std::ptrdiff_t>(pairs_begin);
+                const auto pairs_it_end = pairs.begin() + static_cast<std::ptrdiff_t>(pairs_end);
+
+                forEachBit(m_partners.data(), {0, m_cg.nt_count}, [&](size_t c_nt_code) {
+                    pair_it = std::lower_bound(pair_it, pairs_it_end, c_nt_code, [](const auto& pair, size_t code) {
+                        return pair.right < code;
+                    });
+                    addHeads(*pair_it);
+                });
+            }
+        }
+    }
+}  // namespace fl::algo::cyk
@@ -0,0 +1,213 @@
+#include "CYK_Forest.h"
+
+#include "CYK_Algorithm.h"
+#include "CYK_Chart.h"
+
+#include <stack>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    using namespace fl::algo;
+    using namespace fl::algo::cyk;
+
+    void outputTerminal(std::ostream& out, std::string_view text, const ParseForest::Node& node) {
+        out << "\"" << text.substr(node.begin, node.end - node.begin) << "\"";
+    }
+
+    class ForestBuilder {
+    public:
+        ForestBuilder(ParseForest& forest, std::string_view text, const CompiledGrammar& cg)
+            : m_forest(forest)
+            , m_text(text)
+            , m_cg(cg)
+            , m_chart(text.size(), cg.nt_count)
+            , m_head_offsets(cg.nt_count + 1, 0) {
+        }
+
+        void run() {
+            fillChart(m_chart, m_text, m_cg);
+
+            if (!testBit(m_chart.cell(m_text.size(), 0), m_cg.start_code)) {
+                return;
+            }
+
+            findTerminalMatches(m_text, m_cg, [&](size_t pos, size_t len, size_t nt_code) {
+                m_terminal_spans.insert(key(nt_code, pos, pos + len));
+            });
+
+            initHeadPairs();
+
+            m_forest.root = getNode(m_cg.start_code, 0, m_text.size());
+
+            // The nodes are appended while the earlier ones are expanded,
+            // so the families of every node stay contiguous
+            for (size_t i = 0; i < m_forest.nodes.size(); ++i) {
+                expandNode(i);
+            }
+        }
+
+    private:
+        // The pairs (B, C) of all the rules A -> BC grouped by A
+        void initHeadPairs() {
+            for (size_t h = 0; h < m_cg.heads.size(); ++h) {
+                ++m_head_offsets[m_cg.heads[h] + 1];
+            }
+
+            for (size_t a = 0; a < m_cg.nt_count; ++a) {
+                m_head_offsets[a + 1] += m_head_offsets[a];
+            }
+
+            m_head_pairs.resize(m_cg.heads.size());
+            std::vector<size_t> next(m_head_offsets.begin(), m_head_offsets.end() - 1);
+
+            for (const auto& pair : m_cg.pairs) {
+                for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                    m_head_pairs[next[m_cg.heads[h]]++] = {pair.left, pair.right};
+                }
+            }
+        }
+
+        void expandNode(size_t index) {
+            const auto node = m_forest.nodes[index];
+            const size_t families_begin = m_forest.families.size();
+
+            if (m_terminal_spans.count(key(node.nt_code, node.begin, node.end))) {
+                m_forest.families.push_back({ParseForest::kNoNode, ParseForest::kNoNode});
+            }
+
+            for (size_t k = node.begin + 1; k < node.end; ++k) {
+                const ChartWord* left = m_chart.cell(k - node.begin, node.begin);
+                const ChartWord* right = m_chart.cell(node.end - k, k);
+
+                for (size_t p = m_head_offsets[node.nt_code]; p < m_head_offsets[node.nt_code + 1]; ++p) {
+                    const auto [b_nt_code, c_nt_code] = m_head_pairs[p];
+
+                    if (testBit(left, b_nt_code) && testBit(right, c_nt_code)) {
+                        const size_t left_node = getNode(b_nt_code, node.begin, k);
+                        const size_t right_node = getNode(c_nt_code, k, node.end);
+                        m_forest.families.push_back({left_node, right_node});
+                    }
+                }
+            }
+
+            m_forest.nodes[index].families_begin = families_begin;
+            m_forest.nodes[index].families_end = m_forest.families.size();
+        }
+
+        size_t getNode(size_t nt_code, size_t begin, size_t end) {
+            const auto [it, is_inserted] = m_node_indexes.emplace(key(nt_code, begin, end), m_forest.nodes.size());
+
+            if (is_inserted) {
+                m_forest.nodes.push_back({nt_code, begin, end, 0, 0});
+            }
+
+            return it->second;
+        }
+
+        [[nodiscard]] size_t key(size_t nt_code, size_t begin, size_t end) const noexcept {
+            return triangularIndex(begin, end) * m_cg.nt_count + nt_code;
+        }
+
+    private:
+        ParseForest& m_forest;
+        std::string_view m_text;
+        const CompiledGrammar& m_cg;
+        Chart m_chart;
+
+        std::vector<size_t> m_head_offsets;
+        std::vector<std::pair<size_t, size_t>> m_head_pairs;
+        std::unordered_set<size_t> m_terminal_spans;
+        std::unordered_map<size_t, size_t> m_node_indexes;
+    };
+}  // namespace
+
+namespace fl::algo::cyk {
+    void buildParseForest(ParseForest& forest, std::string_view text, const CompiledGrammar& cg) {
+        forest = ParseForest{};
+
+        if (cg.empty()) {
+            return;
+        }
+
+        if (text.empty()) {
+            if (cg.generates_empty) {
+                forest.root = 0;
+                forest.nodes.push_back({cg.start_code, 0, 0, 0, 1});
+                forest.families.push_back({ParseForest::kNoNode, ParseForest::kNoNode});
+            }
+
+            return;
+        }
+
+        ForestBuilder(forest, text, cg).run();
+    }
+
+    void printParseForest(std::ostream& out,
+                          const ParseForest& forest,
+                          std::string_view text,
+                          const CompiledGrammar& cg) {
+        for (size_t i = 0; i < forest.nodes.size(); ++i) {
+            const auto& node = forest.nodes[i];
+
+            out << i << " " << cg.nt_names[node.nt_code] << " " << node.begin << " " << node.end << " :";
+
+            for (size_t f = node.families_begin; f < node.families_end; ++f) {
+                const auto& family = forest.families[f];
+
+                out << (f == node.families_begin ? " " : " | ");
+
+                if (family.left == ParseForest::kNoNode) {
+                    outputTerminal(out, text, node);
+                } else {
+                    out << family.left << " " << family.right;
+                }
+            }
+
+            out << "\n";
+        }
+    }
+
+    void printParseTree(std::ostream& out,
+                        const ParseForest& forest,
+                        std::string_view text,
+                        const CompiledGrammar& cg) {
+        if (forest.empty()) {
+            return;
+        }
+
+        // A tree may be as deep as the text is long, so no recursion here.
+        // kNoNode on the stack closes the bracket of a node
+        std::stack<size_t> nodes;
+        nodes.push(forest.root);
+
+        while (!nodes.empty()) {
+            const size_t index = nodes.top();
+            nodes.pop();
+
+            if (index == ParseForest::kNoNode) {
+                out << ")";
+                continue;
+            }
+
+            const auto& node = forest.nodes[index];
+            const auto& family = forest.families[node.families_begin];
+
+            out << (index == forest.root ? "(" : " (") << cg.nt_names[node.nt_code];
+
+            if (family.left == ParseForest::kNoNode) {
+                out << " ";
+                outputTerminal(out, text, node);
+                out << ")";
+                continue;
+            }
+
+            nodes.push(ParseForest::kNoNode);
+            nodes.push(family.right);
+            nodes.push(family.left);
+        }
+
+        out << "\n";
+    }
+}  // namespace fl::algo::cyk
@@ -0,0 +1,178 @@
+#include "CYK_Incremental.h"
+
+namespace fl::algo::cyk {
+    IncrementalRecognizer::IncrementalRecognizer(const CompiledGrammar& cg, bool is_prefix_tracked)
+        : m_cg(cg)
+        , m_is_prefix_tracked(is_prefix_tracked)
+        , m_cell_words((cg.nt_count + kChartWordBits - 1) / kChartWordBits)
+        , m_combiner(cg) {
+    }
+
+    void IncrementalRecognizer::append(std::string_view chunk) {
+        if (m_cg.empty()) {
+            m_size += chunk.size();
+            return;
+        }
+
+        for (char ch : chunk) {
+            appendSymbol(ch);
+        }
+    }
+
+    void IncrementalRecognizer::clear() noexcept {
+        m_size = 0;
+        m_viable_size = 0;
+        m_matcher_state = TerminalMatcher::root();
+        m_cells.clear();
+        m_prefixes.clear();
+        m_trie_walks.clear();
+    }
+
+    bool IncrementalRecognizer::isRecognized() const noexcept {
+        if (m_cg.empty()) {
+            return false;
+        }
+
+        if (m_size == 0) {
+            return m_cg.generates_empty;
+        }
+
+        if (m_is_prefix_tracked && !isViable()) {
+            return false;
+        }
+
+        const ChartWord* whole = m_cells.data() + triangularIndex(0, m_size) * m_cell_words;
+
+        return testBit(whole, m_cg.start_code);
+    }
+
+    void IncrementalRecognizer::appendSymbol(char ch) {
+        if (m_is_prefix_tracked && !isViable()) {
+            ++m_size;
+            return;
+        }
+
+        const size_t end = ++m_size;
+
+        m_cells.resize(triangularCellsCount(end) * m_cell_words, 0);
+
+        // Phase 1: the terminals that end at the new character
+        m_matcher_state = m_cg.matcher.next(m_matcher_state, ch);
+        m_cg.matcher.forEachMatch(m_matcher_state, [&](size_t len, size_t nt_code) {
+            setBit(cell(end - len, end), nt_code);
+        });
+
+        // Phase 2: the new column from the shortest substrings to the longest,
+        // so that cell(k, end) is final when cell(begin, end) needs it
+        for (size_t begin = end - 1; begin-- > 0;) {
+            ChartWord* target = cell(begin, end);
+
+            for (size_t k = begin + 1; k < end; ++k) {
+                const ChartWord* right = cell(k, end);
+
+                if (m_combiner.isEmpty(right)) {
+                    continue;
+                }
+
+                m_combiner.combine(target, cell(begin, k), right);
+
+                if (m_combiner.isSaturated(target)) {
+                    break;
+                }
+            }
+        }
+
+        if (m_is_prefix_tracked) {
+            fillPrefixColumn(ch);
+        }
+    }
+
+    /**
+     * A is in prefix(begin, end) if and only if one of the following holds:
+     * 1) A -> t and text[begin:end] is a prefix of t
+     * 2) A -> BC, B is in cell(begin, k) and C is in prefix(k, end) for begin < k < end
+     * 3) A -> BC and B is in prefix(begin, end), which is closed with leftCorners()
+     */
+    void IncrementalRecognizer::fillPrefixColumn(char ch) {
+        const size_t end = m_size;
+        const auto& matcher = m_cg.matcher;
+
+        m_prefixes.resize(m_cells.size(), 0);
+
+        // Phase 1: the terminals that start with text[begin:end]
+        m_trie_walks.emplace_back(end - 1, TerminalMatcher::root());
+
+        size_t alive_count = 0;
+
+        for (auto [begin, state] : m_trie_walks) {
+            state = matcher.child(state, ch);
+
+            if (state == TerminalMatcher::kNoState) {
+                continue;
+            }
+
+            matcher.forEachPrefixMatch(state, [&, begin = begin](size_t nt_code) {
+                setBit(prefix(begin, end), nt_code);
+            });
+
+            m_trie_walks[alive_count++] = {begin, state};
+        }
+
+        m_trie_walks.resize(alive_count);
+
+        // Phase 2: the rules with the left child finished inside the text
+        std::vector<ChartWord> closed(m_cell_words);
+        const auto& left_corners = m_cg.leftCorners();
+        const auto& kernels = getBitKernels();
+
+        for (size_t begin = end; begin-- > 0;) {
+            ChartWord* target = prefix(begin, end);
+
+            for (size_t k = begin + 1; k < end; ++k) {
+                const ChartWord* right = prefix(k, end);
+
+                if (m_combiner.isEmpty(right)) {
+                    continue;
+                }
+
+                m_combiner.combine(target, cell(begin, k), right);
+
+                if (m_combiner.isSaturated(target)) {
+                    break;
+                }
+            }
+
+            // leftCorners() is transitively closed, so one pass over the cell is enough
+            std::copy(target, target + m_cell_words, closed.begin());
+
+            for (size_t w = 0; w < m_cell_words; ++w) {
+                for (ChartWord bits = target[w]; bits != 0; bits &= bits - 1) {
+                    const size_t b_nt_code = w * kChartWordBits + __builtin_ctzll(bits);
+                    const auto* heads = left_corners.data() + b_nt_code * m_cg.nt_words;
+
+                    kernels.or_words(closed.data(), heads, m_cell_words);
+                }
+            }
+
+            std::copy(closed.begin(), closed.end(), target);
+        }
+
+        if (testBit(prefix(0, end), m_cg.start_code)) {
+            m_viable_size = end;
+        }
+    }
+
+    size_t findLongestViablePrefix(std::string_view text, const CompiledGrammar& cg) {
+        IncrementalRecognizer recognizer(cg, true);
+
+        if (cg.empty()) {
+            return 0;
+        }
+
+        for (size_t pos = 0; pos < text.size() && recognizer.isViable(); ++pos) {
+            recognizer.append(text.substr(pos, 1));
+        }
+
+        return recognizer.viablePrefixSize();
+    }
+}  // namespace fl::algo::cyk
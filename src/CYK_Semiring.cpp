@@ -0,0 +1,38 @@
+#include "CYK_Semiring.h"
+
+#include <map>
+#include <utility>
+
+namespace fl::algo::cyk {
+    void findWeightedTerminalMatches(std::string_view text,
+                                     const CompiledGrammar& cg,
+                                     const WeightedMatchCallback& on_match) {
+        // (terminal, nt_code) -> the smallest weight
+        std::map<std::pair<std::string_view, size_t>, double> weights;
+
+        for (const auto& rule : cg.terminal_rules) {
+            const auto [it, is_inserted] = weights.emplace(std::make_pair(std::string_view(rule.terminal), rule.nt_code),
+                                                           rule.weight);
+
+            if (!is_inserted && rule.weight < it->second) {
+                it->second = rule.weight;
+            }
+        }
+
+        findTerminalMatches(text, cg, [&](size_t pos, size_t len, size_t nt_code) {
+            on_match(pos, len, nt_code, weights.at({text.substr(pos, len), nt_code}));
+        });
+    }
+
+    double getEmptyRuleWeight(const CompiledGrammar& cg) {
+        double weight = TropicalSemiring::zero();
+
+        for (const auto& rule : cg.terminal_rules) {
+            if (rule.terminal.empty() && rule.nt_code == cg.start_code && rule.weight < weight) {
+                weight = rule.weight;
+            }
+        }
+
+        return weight;
+    }
+}  // namespace fl::algo::cyk
@@ -1,17 +1,45 @@
 #include "GrammarAlgorithms.h"
 
 #include "Grammar.h"
-#include "NonterminalCompression.h"
+#include "Statistics.h"
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <stack>
 #include <map>
 #include <set>
-#include <unordered_set>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace {
     using namespace fl;
 
+    /**
+     * The reversed graph on the nonterminals: the list of a nonterminal holds
+     * the nonterminals with a rule containing it, the lists are indexed by TokenKey
+     */
+    std::vector<std::vector<TokenKey>> getReversedNonterminalGraph(const Grammar& g) {
+        std::vector<std::vector<TokenKey>> nt_generating_nts(g.tntable.keysEnd());
+
+        for (const auto& [nt_key, multirrs] : g.multirules) {
+            for (const auto& rrs : multirrs) {
+                for (const auto rrs_nt_index : rrs.nt_indexes) {
+                    const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
+                    auto& generating_nts = nt_generating_nts[rrs_nt_key];
+
+                    // The rules of one nonterminal come together, so a repetition is the last element
+                    if (rrs_nt_key != nt_key && (generating_nts.empty() || generating_nts.back() != nt_key)) {
+                        generating_nts.push_back(nt_key);
+                    }
+                }
+            }
+        }
+
+        return nt_generating_nts;
+    }
+
     /**
      * @param g - context-free grammar without any restrictions
      *
@@ -21,14 +49,12 @@ namespace {
      * unreachable (there's no output of the grammar that passes a state with a such nonterminal).
      */
     void deleteUnreachableNonterminals(Grammar& g) {
-        algo::NonterminalTokenKeyTable nt_table;
-        algo::initNonterminalTokenKeyTable(nt_table, g);
-        std::vector<bool> is_nt_seen(nt_table.size());
+        std::vector<bool> is_nt_seen(g.tntable.keysEnd());
 
         std::stack<TokenKey> dfs_stack;
         TokenKey cur;
 
-        is_nt_seen[nt_table[g.start]] = true;
+        is_nt_seen[g.start] = true;
         dfs_stack.push(g.start);
 
         while (!dfs_stack.empty()) {
@@ -39,8 +65,8 @@ namespace {
                 for (const auto rrs_nt_index : rrs.nt_indexes) {
                     const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
 
-                    if (!is_nt_seen[nt_table[rrs_nt_key]]) {
-                        is_nt_seen[nt_table[rrs_nt_key]] = true;
+                    if (!is_nt_seen[rrs_nt_key]) {
+                        is_nt_seen[rrs_nt_key] = true;
                         dfs_stack.push(rrs_nt_key);
                     }
                 }
@@ -48,7 +74,7 @@ namespace {
         }
 
         for (auto it = g.multirules.begin(); it != g.multirules.end();) {
-            if (is_nt_seen[nt_table[it->first]]) {
+            if (is_nt_seen[it->first]) {
                 ++it;
                 continue;
             }
@@ -66,38 +92,19 @@ namespace {
         // Phase 1.1: construct reversed graph on the nonterminals
         //   so that each nonterminal is connected with those which
         //   can produce an output containing the nonterminal
-        std::map<TokenKey, std::set<TokenKey>> nt_generating_nts;
-
-        for (const auto& [nt_key, multirrs] : g.multirules) {
-            for (const auto& rrs : multirrs) {
-                if (rrs.nt_indexes.empty()) {
-                    continue;
-                }
-
-                for (const auto rrs_nt_index : rrs.nt_indexes) {
-                    const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
-
-                    if (rrs_nt_key != nt_key) {
-                        nt_generating_nts[rrs_nt_key].insert(nt_key);
-                    }
-                }
-            }
-        }
+        const auto nt_generating_nts = getReversedNonterminalGraph(g);
 
         // Phase 1.2: find all generative nonterminals
-        algo::NonterminalTokenKeyTable nt_table;
-        algo::initNonterminalTokenKeyTable(nt_table, g);
-        std::vector<State> nt_states(nt_table.size(), kNothing);
-        size_t ungenerative_nt_count = nt_table.size();
-
+        std::vector<State> nt_states(g.tntable.keysEnd(), kNothing);
         std::stack<TokenKey> dfs_stack;
 
         for (const auto& [nt_key, multirrs] : g.multirules) {
             for (const auto& rrs : multirrs) {
+                // A nonterminal with several terminal rules is pushed once
                 if (rrs.nt_indexes.empty()) {
-                    nt_states[nt_table[nt_key]] = kGenerative;
-                    --ungenerative_nt_count;
+                    nt_states[nt_key] = kGenerative;
                     dfs_stack.push(nt_key);
+                    break;
                 }
             }
         }
@@ -109,7 +116,7 @@ namespace {
                 for (const auto rrs_nt_index : rrs.nt_indexes) {
                     const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
 
-                    isGenerativeRule &= static_cast<bool>(nt_states[nt_table[rrs_nt_key]] & kGenerative);
+                    isGenerativeRule &= static_cast<bool>(nt_states[rrs_nt_key] & kGenerative);
 
                     if (!isGenerativeRule) {
                         break;
@@ -129,13 +136,12 @@ namespace {
             dfs_stack.pop(); 
 
             for (TokenKey generating_nt_key : nt_generating_nts[cur]) {
-                 if (nt_states[nt_table[generating_nt_key]] & kGenerative) {
+                 if (nt_states[generating_nt_key] & kGenerative) {
                      continue;
                  }
 
                  if (isNonterminalGenerative(generating_nt_key)) {
-                     nt_states[nt_table[generating_nt_key]] = kGenerative;
-                     --ungenerative_nt_count;
+                     nt_states[generating_nt_key] = kGenerative;
                      dfs_stack.push(generating_nt_key);
                  }
             }
@@ -144,42 +150,29 @@ namespace {
 
         // Phase 2: erasing ungenerative nonterminals
         // Phase 2.1: erase their multirules
-        std::unordered_set<TokenKey> ungenerative_nt_keys;
-        ungenerative_nt_keys.reserve(ungenerative_nt_count);
+        std::vector<bool> is_nt_erased(nt_states.size());
 
         for (auto it = g.multirules.begin(); it != g.multirules.end();) {
             auto nt_key = it->first;
-            if (nt_states[nt_table[nt_key]] & kGenerative) {
+            if (nt_states[nt_key] & kGenerative) {
                 ++it;
                 continue;
             }
 
-            // todo: remove debug
-            std::cout << g.tntable.table[nt_key].token << std::endl;
-
-            ungenerative_nt_keys.insert(nt_key);
+            is_nt_erased[nt_key] = true;
             g.tntable.erase(nt_key, TokenType::kNonterminal);
             it = g.multirules.erase(it);  // todo: handle terminals in g.tntable
         }
 
         // Phase 2.2: erase all the rules where such nonterminals appear
         for (auto& [nt_key, multirrs] : g.multirules) {
-            // todo: remove debug
-            std::cout << "Removing ungenerative rules for the nonterminal " << g.tntable.table[nt_key].token << std::endl;
-
-            std::cout << "Before:\n";
-            for (const auto& rrs : multirrs) {
-                outputRuleRightSide(std::cout, rrs, g.tntable.table);
-                std::cout << std::endl;
-            }
-
             auto rm_it = std::remove_if(multirrs.begin(),
                                         multirrs.end(),
                                         [&](const RuleRightSide& rrs) {
                 for (const auto rrs_nt_index : rrs.nt_indexes) {
                     const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
 
-                    if (ungenerative_nt_keys.find(rrs_nt_key) != ungenerative_nt_keys.end()) {
+                    if (is_nt_erased[rrs_nt_key]) {
                         return true;
                     }
                 }
@@ -187,12 +180,6 @@ namespace {
                 return false;
             });
             multirrs.erase(rm_it, multirrs.end());
-
-            std::cout << "\nAfter:\n";
-            for (const auto& rrs : multirrs) {
-                outputRuleRightSide(std::cout, rrs, g.tntable.table);
-                std::cout << std::endl;
-            }
         }
     }
 
@@ -201,17 +188,17 @@ namespace {
         static std::string nt_prefix = "unique_nonterminal_";
         static size_t nt_number = 0;
 
-        auto& table = g.tntable.table;
-        auto& rtable = g.tntable.rtable;
+        const auto isNonterminal = [&g](std::string_view s) {
+            const auto key = g.tntable.find(s);
+            return key && (g.tntable.type(*key) & TokenType::kNonterminal) != TokenType::kNothing;
+        };
         std::string s = nt_prefix + std::to_string(nt_number);
-        auto it = rtable.find(s);
 
-        while (it != rtable.end() && (table[it->second].type & TokenType::kNonterminal) != TokenType::kNothing) {
+        while (isNonterminal(s)) {
             s = nt_prefix + std::to_string(nt_number++);
-            it = rtable.find(s);
         }
 
-        return g.tntable.insert(std::move(s), TokenType::kNonterminal);
+        return g.tntable.insert(s, TokenType::kNonterminal);
     }
 
     /**
@@ -246,7 +233,7 @@ namespace {
         std::vector<TokenKey> new_nt_keys(rrs.sequence.size());
         auto replaceTerminal = [&](ssize_t j) {
             TokenKey unique_nt_key = insertUniqueNonterminal(g);
-            g.multirules[unique_nt_key] = {RuleRightSide{{rrs.sequence[j]}, {}}};
+            g.multirules[unique_nt_key] = {RuleRightSide{{rrs.sequence[j]}, {}, std::nullopt}};
             new_nt_keys[j] = unique_nt_key;
         };
 
@@ -268,7 +255,7 @@ namespace {
         }
 
         if (rrs.sequence.size() == 2) {
-            g.multirules[nt_key][rrs_ind] = RuleRightSide{{new_nt_keys[0], new_nt_keys[1]}, {0, 1}};
+            g.multirules[nt_key][rrs_ind] = RuleRightSide{{new_nt_keys[0], new_nt_keys[1]}, {0, 1}, rrs.weight};
             return;
         }
 
@@ -276,17 +263,18 @@ namespace {
         TokenKey prev_nt = cur_nt;
         size_t i = new_nt_keys.size() - 2;
 
-        g.multirules[cur_nt].push_back(RuleRightSide{{new_nt_keys[i], new_nt_keys[i + 1]}, {0, 1}});
+        g.multirules[cur_nt].push_back(RuleRightSide{{new_nt_keys[i], new_nt_keys[i + 1]}, {0, 1}, std::nullopt});
 
         while (i > 1) {
             --i;
 
             cur_nt = insertUniqueNonterminal(g);
-            g.multirules[cur_nt].push_back(RuleRightSide{{new_nt_keys[i], prev_nt}, {0, 1}});
+            g.multirules[cur_nt].push_back(RuleRightSide{{new_nt_keys[i], prev_nt}, {0, 1}, std::nullopt});
             prev_nt = cur_nt;
         }
 
-        g.multirules[nt_key][rrs_ind] = RuleRightSide{{new_nt_keys[0], prev_nt}, {0, 1}};
+        // The rule keeps its weight, the new rules of the chain weigh nothing
+        g.multirules[nt_key][rrs_ind] = RuleRightSide{{new_nt_keys[0], prev_nt}, {0, 1}, rrs.weight};
     }
 
     /**
@@ -319,20 +307,18 @@ namespace {
 
         static const State kNothing = 0b00;
         static const State kEmptyGenerative = 0b01;
-        static const State kSeen = 0b10;
 
         // TODO: it's better to do a insertUniqueNonterminal that takes a given prefix
         // so that I can make "unique_start_".
         static const auto addUniqueStart = [](Grammar& g) {
             TokenKey unique_start = insertUniqueNonterminal(g);
-            g.multirules[unique_start].push_back(RuleRightSide{{g.start}, {0}});
+            g.multirules[unique_start].push_back(RuleRightSide{{g.start}, {0}, std::nullopt});
             g.start = unique_start;
         };
 
-        auto empty_it = g.tntable.rtable.find("");
+        const auto empty_key_found = g.tntable.find("");
 
-        if (empty_it == g.tntable.rtable.end() ||
-            (g.tntable.table[empty_it->second].type & TokenType::kTerminal) == TokenType::kNothing) {
+        if (!empty_key_found || (g.tntable.type(*empty_key_found) & TokenType::kTerminal) == TokenType::kNothing) {
             addUniqueStart(g);
             return;
         }
@@ -341,39 +327,25 @@ namespace {
         // Phase 1.1: construct a reversed graph on the nonterminals
         //   so that each nonterminal is connected with those which
         //   can produce an output containing the nonterminal
-        std::map<TokenKey, std::set<TokenKey>> nt_generating_nts;
-
-        for (const auto& [nt_key, multirrs] : g.multirules) {
-            for (const auto& rrs : multirrs) {
-                if (rrs.nt_indexes.empty()) {
-                    continue;
-                }
-
-                for (const auto rrs_nt_index : rrs.nt_indexes) {
-                    const auto rrs_nt_key = rrs.sequence[rrs_nt_index];
-
-                    if (rrs_nt_key != nt_key) {
-                        nt_generating_nts[rrs_nt_key].insert(nt_key);
-                    }
-                }
-            }
-        }
+        const auto nt_generating_nts = getReversedNonterminalGraph(g);
 
         // Phase 1.2: searching basic empty generating nonterminals (which have an empty rule)
-        const TokenKey empty_key = empty_it->second;
+        const TokenKey empty_key = *empty_key_found;
         const auto isEmptyRule = [empty_key](const RuleRightSide& rrs) {
             return rrs.nt_indexes.empty() && std::all_of(rrs.sequence.begin(), rrs.sequence.end(), [empty_key](TokenKey key) {
                 return key == empty_key;
             });
         };
 
-        algo::NonterminalTokenKeyTable nt_table;
-        algo::initNonterminalTokenKeyTable(nt_table, g);
-        std::vector<State> nt_states(nt_table.size(), kNothing);
+        std::vector<State> nt_states(g.tntable.keysEnd(), kNothing);
 
         const auto isEmptyGeneratingRule = [&](const RuleRightSide& rrs) {
-            return rrs.nt_indexes.empty() && std::all_of(rrs.sequence.begin(), rrs.sequence.end(), [&](TokenKey nt_key) {
-                return nt_states[nt_key] & kEmptyGenerative;
+            if (rrs.nt_indexes.empty() || rrs.nt_indexes.size() != rrs.sequence.size()) {
+                return false;
+            }
+
+            return std::all_of(rrs.sequence.begin(), rrs.sequence.end(), [&](TokenKey nt_key) {
+                return (nt_states[nt_key] & kEmptyGenerative) != 0;
             });
         };
         const auto isEmptyGenerativeNonterminal = [&](const TokenKey key) {
@@ -382,14 +354,13 @@ namespace {
             });
         };
 
-        std::unordered_set<TokenKey> nts_with_empty_rule;
-        nts_with_empty_rule.reserve(nt_table.size());
+        std::vector<TokenKey> nts_with_empty_rule;
 
         for (const auto& [nt_key, multirrs] : g.multirules) {
             for (const auto& rrs : multirrs) {
                 if (isEmptyRule(rrs)) {
-                    nt_states[nt_table[nt_key]] = kEmptyGenerative;
-                    nts_with_empty_rule.insert(nt_key);
+                    nt_states[nt_key] = kEmptyGenerative;
+                    nts_with_empty_rule.push_back(nt_key);
                     break;
                 }
             }
@@ -409,12 +380,12 @@ namespace {
                 dfs_stack.pop();
     
                 for (const auto nt_key : nt_generating_nts[cur]) {
-                    if (nt_states[nt_table[nt_key]] & kEmptyGenerative) {
+                    if (nt_states[nt_key] & kEmptyGenerative) {
                         continue;
                     }
     
                     if (isEmptyGenerativeNonterminal(nt_key)) {
-                        nt_states[nt_table[nt_key]] |= kEmptyGenerative;
+                        nt_states[nt_key] |= kEmptyGenerative;
                         dfs_stack.push(nt_key);
                     }
                 }
@@ -422,7 +393,7 @@ namespace {
         }
 
         // Phase 2: searching new rules for each nonterminal by running DFS from the nonterminal
-        std::map<TokenKey, std::set<TokenKey>> multirrs_to_add;
+        std::vector<std::set<TokenKey>> multirrs_to_add(nt_states.size());
 
         {
             struct DFSState {
@@ -430,7 +401,10 @@ namespace {
                 MultiruleRightSide::iterator rrs_it;
             };
 
-            std::vector<State> dfs_nt_states(nt_states.size(), kNothing);
+            // A nonterminal is seen by the current DFS if its stamp is the stamp of the DFS,
+            // so nothing is cleared between the runs
+            std::vector<size_t> seen_stamps(nt_states.size(), 0);
+            size_t dfs_stamp = 0;
             std::stack<DFSState> dfs_stack;
             std::pair<TokenKey, RuleRightSide> fixed_rule;
             const auto testChainRule = [&](const RuleRightSide& rrs) -> std::pair<bool, std::vector<TokenKey>> {
@@ -441,7 +415,7 @@ namespace {
                 if (rrs.nt_indexes.size() == 1) {
                     auto key = rrs.sequence[0];
 
-                    if (dfs_nt_states[nt_table[key]] & kSeen) {
+                    if (seen_stamps[key] == dfs_stamp) {
                         return {false, {}};
                     } else {
                         return {true, {key}};
@@ -452,11 +426,11 @@ namespace {
                 accepted_nts.reserve(2);
 
                 for (int i = 0; i < 2; ++i) {
-                    if (dfs_nt_states[nt_table[rrs.sequence[i]]] & kSeen) {
+                    if (seen_stamps[rrs.sequence[i]] == dfs_stamp) {
                         continue;
                     }
 
-                    if (dfs_nt_states[nt_table[rrs.sequence[1 - i]]] & kEmptyGenerative) {
+                    if (nt_states[rrs.sequence[1 - i]] & kEmptyGenerative) {
                         accepted_nts.push_back(rrs.sequence[i]);
                     }
                 }
@@ -465,8 +439,7 @@ namespace {
             };
     
             for (auto& [nt_key, multirrs] : g.multirules) {
-                dfs_nt_states = nt_states;
-                dfs_nt_states[nt_table[nt_key]] |= kSeen;
+                seen_stamps[nt_key] = ++dfs_stamp;
                 dfs_stack.push({nt_key, multirrs.begin()});
     
                 while (!dfs_stack.empty()) {
@@ -485,7 +458,7 @@ namespace {
                                 }
 
                                 for (int i = 0; i < 2; ++i) {
-                                    if (dfs_nt_states[nt_table[rrs.sequence[1 - i]]] & kEmptyGenerative) {
+                                    if (nt_states[rrs.sequence[1 - i]] & kEmptyGenerative) {
                                         rrs_to_add.insert(rrs.sequence[i]);
                                     }
                                 }
@@ -500,7 +473,7 @@ namespace {
                             }
 
                             for (auto next_nt_key : next_nt_keys) {
-                                dfs_nt_states[nt_table[next_nt_key]] |= kSeen;
+                                seen_stamps[next_nt_key] = dfs_stamp;
                                 dfs_stack.push({next_nt_key, g.multirules[next_nt_key].begin()});
                             }
                         }
@@ -510,9 +483,9 @@ namespace {
         }
        
         // Phase 3: adding new rules
-        for (const auto& [nt_key, rrs_to_add] : multirrs_to_add) {
-            for (const auto rrs_nt_key : rrs_to_add) {
-                g.multirules[nt_key].push_back({{rrs_nt_key}, {0}});
+        for (TokenKey nt_key = 0; nt_key < multirrs_to_add.size(); ++nt_key) {
+            for (const auto rrs_nt_key : multirrs_to_add[nt_key]) {
+                g.multirules[nt_key].push_back({{rrs_nt_key}, {0}, std::nullopt});
             }
         }
 
@@ -521,8 +494,8 @@ namespace {
 
         addUniqueStart(g);
 
-        if (nt_states[nt_table[old_start]] & kEmptyGenerative) {
-            g.multirules[g.start].push_back({{empty_key}, {}});
+        if (nt_states[old_start] & kEmptyGenerative) {
+            g.multirules[g.start].push_back({{empty_key}, {}, std::nullopt});
         }
 
         // Phase 5: deleting empty rules
@@ -548,12 +521,6 @@ namespace {
      * The function removes the rules that match the last pattern
      */
     void deleteNonterminalChains(Grammar& g) {
-        using ParentsSet = std::unordered_set<TokenKey>;
-
-        static const auto isChainRule = [](const RuleRightSide& rrs) {
-            return rrs.nt_indexes.size() == 1;
-        };
-
         // Phase 1: divide the old multirules to the chain multirules and the remaining
         MultirulesMap chain_multirules;
 
@@ -561,7 +528,8 @@ namespace {
             auto nt_key = multirule.first;
             auto& multirrs = multirule.second;
             auto rm_it = std::remove_if(multirrs.begin(), multirrs.end(), [&](auto& rrs) {
-                bool result = isChainRule(rrs);
+                // A chain rule is A -> B
+                const bool result = rrs.nt_indexes.size() == 1;
 
                 if (result) {
                     chain_multirules[nt_key].push_back(std::move(rrs));
@@ -574,37 +542,39 @@ namespace {
         }
 
         // Phase 2: find all the parents for each nonterminal
-        algo::NonterminalTokenKeyTable nt_table;
-        algo::initNonterminalTokenKeyTable(nt_table, g);
-
-        std::vector<ParentsSet> parents(nt_table.size());
-        std::vector<unsigned> chain_color(nt_table.size());
+        // A DFS visits a nonterminal once, so a parent is never repeated
+        std::vector<std::vector<TokenKey>> parents(g.tntable.keysEnd());
+        std::vector<unsigned> chain_color(g.tntable.keysEnd());
         unsigned available_color = 1;
 
         // todo: potentially can be done in "one" efficient DFS with colour backtracing
         for (auto& [nt_key, multirrs] : chain_multirules) {
-            auto nt_code = nt_table[nt_key];
             std::stack<TokenKey> dfs_stack;
             TokenKey cur;
 
-            chain_color[nt_code] = available_color;
+            chain_color[nt_key] = available_color;
             dfs_stack.push(nt_key);
 
             while (!dfs_stack.empty()) {
                 cur = dfs_stack.top();
                 dfs_stack.pop();
 
-                for (auto& rrs : chain_multirules[cur]) {
+                const auto cur_it = chain_multirules.find(cur);
+
+                if (cur_it == chain_multirules.end()) {
+                    continue;
+                }
+
+                for (auto& rrs : cur_it->second) {
                     auto next_nt_key = rrs.sequence[0];
-                    auto next_nt_code = nt_table[next_nt_key];
-                    auto& next_nt_color = chain_color[next_nt_code];
+                    auto& next_nt_color = chain_color[next_nt_key];
 
                     if (next_nt_color == available_color) {
                         continue;
                     }
 
                     next_nt_color = available_color;
-                    parents[next_nt_code].insert(nt_key);
+                    parents[next_nt_key].push_back(nt_key);
                     dfs_stack.push(next_nt_key);
                 }
             }
@@ -612,54 +582,141 @@ namespace {
             ++available_color;
         }
 
-        // Phase 3: bring new rules to the remaining
-        for (auto& [nt_key, multirrs] : g.multirules) {
-            auto nt_code = nt_table[nt_key];
+        // Phase 3: bring new rules to the remaining.
+        // The rules are gathered aside, so that only the original rules are copied
+        // and no vector grows while it is walked (a chain cycle makes A a parent of itself)
+        MultirulesMap inherited_multirules;
 
-            if (parents[nt_code].empty()) {
-                continue;
-            }
-
-            for (auto& rrs : multirrs) {
-                if (isChainRule(rrs)) {
+        for (auto& [nt_key, multirrs] : g.multirules) {
+            for (auto parent : parents[nt_key]) {
+                if (parent == nt_key) {
                     continue;
                 }
 
-                for (auto parent : parents[nt_code]) {
-                    g.multirules[parent].push_back(rrs);
-                }
+                auto& inherited = inherited_multirules[parent];
+                inherited.insert(inherited.end(), multirrs.begin(), multirrs.end());
             }
         }
+
+        for (auto& [nt_key, inherited] : inherited_multirules) {
+            auto& multirrs = g.multirules[nt_key];
+            multirrs.insert(multirrs.end(),
+                            std::make_move_iterator(inherited.begin()),
+                            std::make_move_iterator(inherited.end()));
+        }
+    }
+
+    /**
+     * A pass of the conversion. A removing pass only deletes nonterminals and rules,
+     * so it finds nothing to delete in a grammar it has already cleaned, and it is skipped
+     * if no pass has changed the grammar since its last run.
+     */
+    struct ConversionPass {
+        const char* name;
+        void (*run)(Grammar&);
+        bool is_removing;
+    };
+
+    const ConversionPass kUnreachablePass{"unreachable", deleteUnreachableNonterminals, true};
+    const ConversionPass kUngenerativePass{"ungenerative", deleteUngenerativeNonterminals, true};
+    const ConversionPass kMixedAndLongPass{"mixed_and_long", deleteMixedAndLongRules, false};
+    const ConversionPass kEmptyGeneratingPass{"empty_generating", congregateEmptyGeneratingNonterminals, false};
+    const ConversionPass kChainsPass{"chains", deleteNonterminalChains, false};
+
+    // The conversion stops after the phase with the number end_phase, the phases are numbered from 1
+    const std::vector<std::vector<const ConversionPass*>> kConversionPhases = {
+        {&kUnreachablePass, &kUngenerativePass, &kUnreachablePass},
+        {&kMixedAndLongPass},
+        {&kEmptyGeneratingPass},
+        {&kChainsPass},
+        {&kUnreachablePass, &kUngenerativePass, &kUnreachablePass}
+    };
+
+    size_t countRules(const Grammar& g) {
+        size_t rules_count = 0;
+
+        for (const auto& [nt_key, multirrs] : g.multirules) {
+            rules_count += multirrs.size();
+        }
+
+        return rules_count;
+    }
+
+    void dumpGrammar(const Grammar& g, const std::filesystem::path& dump_directory, size_t pass_number, const char* name) {
+        const auto path = dump_directory / ((pass_number < 10 ? "0" : "") + std::to_string(pass_number) + "_" + name + ".txt");
+        std::ofstream fout(path);
+
+        if (!fout.good()) {
+            throw std::runtime_error("failed to open the file " + path.string() + " for a conversion dump.\n");
+        }
+
+        fout << g;
     }
 }  // namespace
 
 namespace fl::algo {
-    void convertToChomskyForm(Grammar& g, int end_phase) {
-        // todo: use end_phase
-        std::ignore = end_phase;
-
+    void convertToChomskyForm(Grammar& g, const ConversionOptions& options) {
         if (g.multirules.empty()) {
             return;
         }
 
-        deleteUnreachableNonterminals(g);
-        std::cout << g << "\n*******************************Unreachable" << std::endl;
-        deleteUngenerativeNonterminals(g);
-        std::cout << g << "\n*******************************Ungenerative" << std::endl;
-        deleteUnreachableNonterminals(g);
-        std::cout << g << "\n*******************************Unreachable" << std::endl;
-        deleteMixedAndLongRules(g);
-        std::cout << g << "\n*******************************MixedAndLongRules" << std::endl;
-        congregateEmptyGeneratingNonterminals(g);
-        std::cout << g << '\n' << g.tntable.table[g.start].token << "\n*******************************EmptyGenerating" << std::endl;
-        deleteNonterminalChains(g);
-        std::cout << g << "\n*******************************Nonterminal" << std::endl;
-        deleteUnreachableNonterminals(g);
-        std::cout << g << "\n*******************************Unreachable\n";
-        deleteUngenerativeNonterminals(g);
-        std::cout << g << "\n*******************************Ungenerative\n";
-        deleteUnreachableNonterminals(g);
-        std::cout << g << "\n*******************************Unreachable\n";
+        const size_t phases_count = options.end_phase <= 0
+                                    ? kConversionPhases.size()
+                                    : std::min(static_cast<size_t>(options.end_phase), kConversionPhases.size());
+
+        // grammar_version grows with every change of the grammar,
+        // clean_versions keeps the version each removing pass has left behind
+        size_t grammar_version = 0;
+        std::map<const ConversionPass*, size_t> clean_versions;
+        size_t pass_number = 0;
+
+        for (size_t phase = 0; phase < phases_count; ++phase) {
+            for (const ConversionPass* pass : kConversionPhases[phase]) {
+                const auto clean_it = clean_versions.find(pass);
+                const bool is_skipped = clean_it != clean_versions.end() && clean_it->second == grammar_version;
+
+                PassStatistics pass_stats;
+                pass_stats.name = pass->name;
+                pass_stats.is_skipped = is_skipped;
+                pass_stats.nonterminals_before = g.multirules.size();
+                pass_stats.rules_before = countRules(g);
+
+                if (!is_skipped) {
+                    const auto start = StatisticsClock::now();
+                    pass->run(g);
+                    pass_stats.seconds = getSecondsSince(start);
+                }
+
+                pass_stats.nonterminals_after = g.multirules.size();
+                pass_stats.rules_after = countRules(g);
+
+                if (!pass->is_removing) {
+                    ++grammar_version;
+                } else {
+                    if (pass_stats.nonterminals_after != pass_stats.nonterminals_before ||
+                        pass_stats.rules_after != pass_stats.rules_before) {
+                        ++grammar_version;
+                    }
+
+                    clean_versions[pass] = grammar_version;
+                }
+
+                if (options.dump_directory) {
+                    dumpGrammar(g, *options.dump_directory, ++pass_number, pass->name);
+                }
+
+                if (options.statistics) {
+                    options.statistics->passes.push_back(std::move(pass_stats));
+                }
+            }
+        }
     }
 
+    void convertToChomskyForm(Grammar& g, int end_phase, ConversionStatistics* statistics) {
+        ConversionOptions options;
+        options.end_phase = end_phase;
+        options.statistics = statistics;
+
+        convertToChomskyForm(g, options);
+    }
 }  // namespace fl::algo
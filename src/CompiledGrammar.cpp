@@ -0,0 +1,234 @@
+#include "CompiledGrammar.h"
+
+#include "NonterminalCompression.h"
+
+#include <algorithm>
+#include <stack>
+#include <stdexcept>
+#include <tuple>
+
+namespace fl::algo {
+    const CompiledGrammar::RulePair* CompiledGrammar::findPair(size_t left, size_t right) const noexcept {
+        if (left >= nt_count) {
+            return nullptr;
+        }
+
+        auto begin = pairs.begin() + static_cast<ssize_t>(left_offsets[left]);
+        auto end = pairs.begin() + static_cast<ssize_t>(left_offsets[left + 1]);
+        auto it = std::lower_bound(begin, end, right, [](const RulePair& p, size_t r) {
+            return p.right < r;
+        });
+
+        return it != end && it->right == right ? &*it : nullptr;
+    }
+
+    const std::vector<uint64_t>& CompiledGrammar::leftCorners() const {
+        std::call_once(m_lazy_bitsets->left_corners_flag, [this] {
+            auto& left_corners = m_lazy_bitsets->left_corners;
+            left_corners.assign(nt_count * nt_words, 0);
+
+            // A DFS from every nonterminal B up through the rules that have B as the left child
+            for (size_t b = 0; b < nt_count; ++b) {
+                uint64_t* reached = left_corners.data() + b * nt_words;
+                std::stack<size_t> dfs_stack;
+
+                reached[b / 64] |= uint64_t{1} << (b % 64);
+                dfs_stack.push(b);
+
+                while (!dfs_stack.empty()) {
+                    const size_t cur = dfs_stack.top();
+                    dfs_stack.pop();
+
+                    for (size_t p = left_offsets[cur]; p < left_offsets[cur + 1]; ++p) {
+                        for (size_t h = pairs[p].heads_begin; h < pairs[p].heads_end; ++h) {
+                            const size_t head = heads[h];
+                            const uint64_t mask = uint64_t{1} << (head % 64);
+
+                            if (reached[head / 64] & mask) {
+                                continue;
+                            }
+
+                            reached[head / 64] |= mask;
+                            dfs_stack.push(head);
+                        }
+                    }
+                }
+            }
+        });
+
+        return m_lazy_bitsets->left_corners;
+    }
+
+    const std::vector<uint64_t>& CompiledGrammar::leftDescendants() const {
+        std::call_once(m_lazy_bitsets->left_descendants_flag, [this] {
+            // The left children of every head: left_children[left_children_offsets[A]:left_children_offsets[A + 1]]
+            std::vector<size_t> left_children_offsets(nt_count + 1, 0);
+            std::vector<size_t> left_children(heads.size());
+
+            for (const auto& pair : pairs) {
+                for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                    ++left_children_offsets[heads[h] + 1];
+                }
+            }
+
+            for (size_t a = 0; a < nt_count; ++a) {
+                left_children_offsets[a + 1] += left_children_offsets[a];
+            }
+
+            std::vector<size_t> filled(left_children_offsets.begin(), left_children_offsets.end() - 1);
+
+            for (const auto& pair : pairs) {
+                for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                    left_children[filled[heads[h]]++] = pair.left;
+                }
+            }
+
+            auto& left_descendants = m_lazy_bitsets->left_descendants;
+            left_descendants.assign(nt_count * nt_words, 0);
+
+            // A DFS from every nonterminal A down through the left children of its rules
+            for (size_t a = 0; a < nt_count; ++a) {
+                uint64_t* reached = left_descendants.data() + a * nt_words;
+                std::stack<size_t> dfs_stack;
+
+                reached[a / 64] |= uint64_t{1} << (a % 64);
+                dfs_stack.push(a);
+
+                while (!dfs_stack.empty()) {
+                    const size_t cur = dfs_stack.top();
+                    dfs_stack.pop();
+
+                    for (size_t i = left_children_offsets[cur]; i < left_children_offsets[cur + 1]; ++i) {
+                        const size_t child = left_children[i];
+                        const uint64_t mask = uint64_t{1} << (child % 64);
+
+                        if (reached[child / 64] & mask) {
+                            continue;
+                        }
+
+                        reached[child / 64] |= mask;
+                        dfs_stack.push(child);
+                    }
+                }
+            }
+        });
+
+        return m_lazy_bitsets->left_descendants;
+    }
+
+    void initCompiledGrammar(CompiledGrammar& cg, const Grammar& g) {
+        cg = CompiledGrammar{};
+
+        if (g.multirules.empty()) {
+            return;
+        }
+
+        NonterminalTokenKeyTable nt_table;
+        initNonterminalTokenKeyTable(nt_table, g);
+
+        cg.nt_count = nt_table.size();
+        cg.start_code = nt_table[g.start];
+        cg.nt_names.resize(cg.nt_count);
+
+        for (size_t nt_code = 0; nt_code < cg.nt_count; ++nt_code) {
+            cg.nt_names[nt_code] = g.tntable.token(nt_table.key(nt_code));
+        }
+
+        // (left, right, head, weight)
+        std::vector<std::tuple<size_t, size_t, size_t, double>> binary_rules;
+
+        for (const auto& [nt_key, multirrs] : g.multirules) {
+            const size_t nt_code = nt_table[nt_key];
+
+            for (const auto& rrs : multirrs) {
+                if (!rrs.nt_indexes.empty()) {
+                    // Here we depend on CNF. If there are nonterminals
+                    // in the rrs, then it's possible only and only when
+                    // the rule looks like A -> BC
+                    if (rrs.nt_indexes.size() != 2 || rrs.sequence.size() != 2) {
+                        throw std::invalid_argument("only a grammar in the Chomsky form can be compiled.\n");
+                    }
+
+                    binary_rules.emplace_back(nt_table[rrs.sequence[0]],
+                                              nt_table[rrs.sequence[1]],
+                                              nt_code,
+                                              rrs.weight.value_or(0));
+                    continue;
+                }
+
+                std::string terminal;
+
+                for (auto t_key : rrs.sequence) {
+                    terminal += g.tntable.token(t_key);
+                }
+
+                if (terminal.empty() && nt_code == cg.start_code) {
+                    cg.generates_empty = true;
+                }
+
+                cg.terminal_rules.push_back({std::move(terminal), nt_code, rrs.weight.value_or(0)});
+            }
+        }
+
+        // A repeated rule is kept once with its smallest weight
+        std::sort(binary_rules.begin(), binary_rules.end());
+        binary_rules.erase(std::unique(binary_rules.begin(), binary_rules.end(), [](const auto& a, const auto& b) {
+            return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b) && std::get<2>(a) == std::get<2>(b);
+        }), binary_rules.end());
+
+        cg.heads.reserve(binary_rules.size());
+        cg.head_weights.reserve(binary_rules.size());
+        cg.left_offsets.assign(cg.nt_count + 1, 0);
+
+        for (const auto& [left, right, head, weight] : binary_rules) {
+            if (cg.pairs.empty() || cg.pairs.back().left != left || cg.pairs.back().right != right) {
+                cg.pairs.push_back({left, right, cg.heads.size(), cg.heads.size()});
+                ++cg.left_offsets[left + 1];
+            }
+
+            cg.heads.push_back(head);
+            cg.head_weights.push_back(weight);
+            ++cg.pairs.back().heads_end;
+        }
+
+        for (size_t b = 0; b < cg.nt_count; ++b) {
+            cg.left_offsets[b + 1] += cg.left_offsets[b];
+        }
+
+        for (const auto& rule : cg.terminal_rules) {
+            cg.matcher.addPattern(rule.terminal, rule.nt_code);
+        }
+
+        cg.matcher.build();
+
+        cg.nt_words = (cg.nt_count + 63) / 64;
+        cg.binary_heads.assign(cg.nt_words, 0);
+
+        for (size_t head : cg.heads) {
+            cg.binary_heads[head / 64] |= uint64_t{1} << (head % 64);
+        }
+
+        cg.partner_rows.assign(cg.nt_count, kNoPartnerRow);
+        size_t rows_count = 0;
+
+        for (size_t b = 0; b < cg.nt_count; ++b) {
+            if (cg.left_offsets[b + 1] - cg.left_offsets[b] >= kPartnerRowMinPairs) {
+                cg.partner_rows[b] = rows_count++;
+            }
+        }
+
+        cg.right_partners.assign(rows_count * cg.nt_words, 0);
+
+        for (const auto& pair : cg.pairs) {
+            if (const size_t row = cg.partner_rows[pair.left]; row != kNoPartnerRow) {
+                cg.right_partners[row * cg.nt_words + pair.right / 64] |= uint64_t{1} << (pair.right % 64);
+            }
+        }
+    }
+
+    void findTerminalMatches(std::string_view text,
+                             const CompiledGrammar& cg,
+                             const TerminalMatchCallback& on_match) {
+        cg.matcher.findMatches(text, on_match);
+    }
+}  // namespace fl::algo
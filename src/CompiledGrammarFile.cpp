@@ -0,0 +1,456 @@
+#include "CompiledGrammarFile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+    constexpr uint32_t kFormatVersion = 7;
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+    constexpr size_t kSectionAlignment = 8;
+
+    enum Section : size_t {
+        kNtNameOffsets,
+        kNtNames,
+        kTerminalOffsets,
+        kTerminals,
+        kTerminalNtCodes,
+        kTerminalWeights,
+        kPairs,
+        kHeads,
+        kHeadWeights,
+        kLeftOffsets,
+        kPartnerRows,
+        kRightPartners,
+        kBinaryHeads,
+        kMatcherNodes,
+        kMatcherEdges,
+        kMatcherPatterns,
+        kMatcherNtCodes,
+        kMatcherPrefixNtCodes,
+        kSectionsCount
+    };
+
+    struct SectionEntry {
+        uint64_t offset;
+        uint64_t size;  // in bytes
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t word_size;
+        uint64_t nt_count;
+        uint64_t start_code;
+        uint64_t generates_empty;
+        uint64_t nt_words;
+        SectionEntry sections[kSectionsCount];
+    };
+
+    static_assert(std::is_trivially_copyable_v<FileHeader>);
+    static_assert(sizeof(FileHeader) % kSectionAlignment == 0);
+
+    class FileWriter {
+    public:
+        FileWriter()
+            : m_buffer(sizeof(FileHeader), '\0') {
+        }
+
+        template <typename T>
+        void writeSection(Section section, const T* items, size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            const size_t size = count * sizeof(T);
+
+            m_buffer.resize((m_buffer.size() + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment, '\0');
+            m_header.sections[section] = {m_buffer.size(), size};
+            m_buffer.append(reinterpret_cast<const char*>(items), size);
+        }
+
+        template <typename T>
+        void writeSection(Section section, const std::vector<T>& items) {
+            writeSection(section, items.data(), items.size());
+        }
+
+        // Writes the strings into one arena and their bounds into another section
+        template <typename Strings, typename GetString>
+        void writeArena(Section offsets_section, Section arena_section, const Strings& strings, GetString get) {
+            std::vector<uint64_t> offsets{0};
+            std::string arena;
+
+            for (const auto& item : strings) {
+                arena += get(item);
+                offsets.push_back(arena.size());
+            }
+
+            writeSection(offsets_section, offsets);
+            writeSection(arena_section, arena.data(), arena.size());
+        }
+
+        [[nodiscard]] FileHeader& header() noexcept { return m_header; }
+
+        void flush(std::ostream& out) {
+            std::memcpy(m_buffer.data(), &m_header, sizeof(FileHeader));
+            out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        }
+
+    private:
+        FileHeader m_header{};
+        std::string m_buffer;
+    };
+
+    class FileReader {
+    public:
+        explicit FileReader(std::string_view data)
+            : m_data(data) {
+            if (!fl::algo::isCompiledGrammarFile(data) || data.size() < sizeof(FileHeader)) {
+                throw std::runtime_error("the file is not a compiled grammar.\n");
+            }
+
+            std::memcpy(&m_header, data.data(), sizeof(FileHeader));
+
+            if (m_header.version != kFormatVersion) {
+                throw std::runtime_error("the compiled grammar has an unsupported format version.\n");
+            }
+
+            if (m_header.byte_order != kByteOrderMark || m_header.word_size != sizeof(size_t)) {
+                throw std::runtime_error("the compiled grammar was written on an incompatible machine.\n");
+            }
+        }
+
+        [[nodiscard]] const FileHeader& header() const noexcept { return m_header; }
+
+        template <typename T>
+        void readSection(Section section, std::vector<T>& items) const {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            const auto [offset, size] = m_header.sections[section];
+
+            if (offset > m_data.size() || size > m_data.size() - offset || size % sizeof(T) != 0) {
+                throw std::runtime_error("the compiled grammar is corrupted.\n");
+            }
+
+            items.resize(size / sizeof(T));
+
+            if (size != 0) {
+                std::memcpy(items.data(), m_data.data() + offset, size);
+            }
+        }
+
+        template <typename Strings, typename SetString>
+        void readArena(Section offsets_section, Section arena_section, Strings& strings, SetString set) const {
+            std::vector<uint64_t> offsets;
+            std::vector<char> arena;
+
+            readSection(offsets_section, offsets);
+            readSection(arena_section, arena);
+
+            if (offsets.empty() || offsets.back() != arena.size()) {
+                throw std::runtime_error("the compiled grammar is corrupted.\n");
+            }
+
+            strings.resize(offsets.size() - 1);
+
+            for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+                if (offsets[i] > offsets[i + 1]) {
+                    throw std::runtime_error("the compiled grammar is corrupted.\n");
+                }
+
+                set(strings[i], std::string(arena.data() + offsets[i], offsets[i + 1] - offsets[i]));
+            }
+        }
+
+    private:
+        std::string_view m_data;
+        FileHeader m_header{};
+    };
+
+    /**
+     * The engines index the charts with the codes from the file without any checks,
+     * so every code, every range and every order they rely on is verified
+     */
+    bool isConsistent(const fl::algo::CompiledGrammar& cg) {
+        using fl::algo::kNoPartnerRow;
+        using fl::algo::kPartnerRowMinPairs;
+
+        if (cg.empty()) {
+            return cg.pairs.empty() && cg.heads.empty() && cg.terminal_rules.empty() && cg.nt_words == 0;
+        }
+
+        const size_t nt_count = cg.nt_count;
+        const size_t nt_words = cg.nt_words;
+
+        if (cg.start_code >= nt_count ||
+            nt_words != (nt_count + 63) / 64 ||
+            cg.nt_names.size() != nt_count ||
+            cg.head_weights.size() != cg.heads.size() ||
+            cg.left_offsets.size() != nt_count + 1 ||
+            cg.partner_rows.size() != nt_count ||
+            cg.right_partners.size() % nt_words != 0 ||
+            cg.binary_heads.size() != nt_words) {
+            return false;
+        }
+
+        for (const auto& rule : cg.terminal_rules) {
+            if (rule.nt_code >= nt_count) {
+                return false;
+            }
+        }
+
+        std::vector<uint64_t> binary_heads(nt_words, 0);
+
+        for (size_t head : cg.heads) {
+            if (head >= nt_count) {
+                return false;
+            }
+
+            binary_heads[head / 64] |= uint64_t{1} << (head % 64);
+        }
+
+        if (binary_heads != cg.binary_heads) {
+            return false;
+        }
+
+        // The pairs are sorted by (left, right) without repeats and left_offsets indexes them
+        if (cg.left_offsets.front() != 0 || cg.left_offsets.back() != cg.pairs.size()) {
+            return false;
+        }
+
+        const size_t partner_rows_count = cg.right_partners.size() / nt_words;
+        std::vector<uint64_t> right_partners(cg.right_partners.size(), 0);
+
+        for (size_t b = 0; b < nt_count; ++b) {
+            const size_t pairs_begin = cg.left_offsets[b];
+            const size_t pairs_end = cg.left_offsets[b + 1];
+            const size_t partner_row = cg.partner_rows[b];
+
+            if (pairs_begin > pairs_end ||
+                (partner_row == kNoPartnerRow) != (pairs_end - pairs_begin < kPartnerRowMinPairs) ||
+                (partner_row != kNoPartnerRow && partner_row >= partner_rows_count)) {
+                return false;
+            }
+
+            for (size_t p = pairs_begin; p < pairs_end; ++p) {
+                const auto& pair = cg.pairs[p];
+
+                if (pair.left != b || pair.right >= nt_count ||
+                    (p > pairs_begin && cg.pairs[p - 1].right >= pair.right) ||
+                    pair.heads_begin >= pair.heads_end || pair.heads_end > cg.heads.size()) {
+                    return false;
+                }
+
+                if (partner_row != kNoPartnerRow) {
+                    right_partners[partner_row * nt_words + pair.right / 64] |= uint64_t{1} << (pair.right % 64);
+                }
+            }
+        }
+
+        // Every right partner must have its pair, combineCells looks the pairs up by them
+        return right_partners == cg.right_partners;
+    }
+}  // namespace
+
+namespace fl::algo {
+    struct CompiledGrammarSerializer {
+        static void write(FileWriter& writer, const TerminalMatcher& matcher) {
+            writer.writeSection(kMatcherNodes, matcher.m_nodes);
+            writeEdges(writer, matcher.m_edges);
+            writer.writeSection(kMatcherPatterns, matcher.m_patterns);
+            writer.writeSection(kMatcherNtCodes, matcher.m_nt_codes);
+            writer.writeSection(kMatcherPrefixNtCodes, matcher.m_prefix_nt_codes);
+        }
+
+        // The padding of the edges is zeroed, so that the same grammar always gives the same file
+        static void writeEdges(FileWriter& writer, const std::vector<TerminalMatcher::Edge>& edges) {
+            using Edge = TerminalMatcher::Edge;
+
+            std::vector<char> bytes(edges.size() * sizeof(Edge), '\0');
+
+            for (size_t i = 0; i < edges.size(); ++i) {
+                char* edge = bytes.data() + i * sizeof(Edge);
+                std::memcpy(edge + offsetof(Edge, ch), &edges[i].ch, sizeof(edges[i].ch));
+                std::memcpy(edge + offsetof(Edge, target), &edges[i].target, sizeof(edges[i].target));
+            }
+
+            writer.writeSection(kMatcherEdges, bytes);
+        }
+
+        static void read(const FileReader& reader, TerminalMatcher& matcher) {
+            matcher.clear();
+            reader.readSection(kMatcherNodes, matcher.m_nodes);
+            reader.readSection(kMatcherEdges, matcher.m_edges);
+            reader.readSection(kMatcherPatterns, matcher.m_patterns);
+            reader.readSection(kMatcherNtCodes, matcher.m_nt_codes);
+            reader.readSection(kMatcherPrefixNtCodes, matcher.m_prefix_nt_codes);
+        }
+
+        /**
+         * The automaton is walked without any bounds checks, so every index must be in range.
+         * The nodes come after their parents in the trie, and the failure and output links
+         * lead to shallower nodes, otherwise a walk could loop forever.
+         */
+        static bool isValid(const TerminalMatcher& matcher, size_t nt_count) {
+            using Matcher = TerminalMatcher;
+
+            const auto& nodes = matcher.m_nodes;
+            const auto& edges = matcher.m_edges;
+            const auto& patterns = matcher.m_patterns;
+
+            // Even a grammar without terminals has the root state
+            if (nt_count == 0 || nodes.empty()) {
+                return nt_count == 0 && nodes.empty() && patterns.empty() && edges.empty();
+            }
+
+            std::vector<size_t> depths(nodes.size(), 0);
+
+            for (size_t state = 0; state < nodes.size(); ++state) {
+                const auto& node = nodes[state];
+
+                if (node.edges_begin > node.edges_end || node.edges_end > edges.size()) {
+                    return false;
+                }
+
+                for (size_t e = node.edges_begin; e < node.edges_end; ++e) {
+                    if (edges[e].target <= state || edges[e].target >= nodes.size() ||
+                        (e > node.edges_begin && edges[e - 1].ch >= edges[e].ch)) {
+                        return false;
+                    }
+
+                    depths[edges[e].target] = depths[state] + 1;
+                }
+            }
+
+            for (size_t state = 0; state < nodes.size(); ++state) {
+                const auto& node = nodes[state];
+                const bool is_root = state == Matcher::root();
+
+                if (node.fail >= nodes.size() || (!is_root && depths[node.fail] >= depths[state])) {
+                    return false;
+                }
+
+                if (node.output != Matcher::kNoState &&
+                    (node.output >= nodes.size() || depths[node.output] >= depths[state] ||
+                     nodes[node.output].pattern == Matcher::kNoPattern)) {
+                    return false;
+                }
+
+                if (node.pattern != Matcher::kNoPattern &&
+                    (is_root || node.pattern >= patterns.size() || patterns[node.pattern].length != depths[state])) {
+                    return false;
+                }
+
+                if (node.prefix_nt_codes_begin > node.prefix_nt_codes_end ||
+                    node.prefix_nt_codes_end > matcher.m_prefix_nt_codes.size()) {
+                    return false;
+                }
+            }
+
+            for (const auto& pattern : patterns) {
+                if (pattern.nt_codes_begin > pattern.nt_codes_end || pattern.nt_codes_end > matcher.m_nt_codes.size()) {
+                    return false;
+                }
+            }
+
+            auto isCode = [nt_count](size_t nt_code) {
+                return nt_code < nt_count;
+            };
+
+            return std::all_of(matcher.m_nt_codes.begin(), matcher.m_nt_codes.end(), isCode) &&
+                   std::all_of(matcher.m_prefix_nt_codes.begin(), matcher.m_prefix_nt_codes.end(), isCode);
+        }
+    };
+
+    bool isCompiledGrammarFile(std::string_view data) noexcept {
+        return data.substr(0, kCompiledGrammarMagic.size()) == kCompiledGrammarMagic;
+    }
+
+    void saveCompiledGrammar(std::ostream& out, const CompiledGrammar& cg) {
+        FileWriter writer;
+
+        writer.writeArena(kNtNameOffsets, kNtNames, cg.nt_names, [](const std::string& name) -> const std::string& {
+            return name;
+        });
+        writer.writeArena(kTerminalOffsets, kTerminals, cg.terminal_rules, [](const auto& rule) -> const std::string& {
+            return rule.terminal;
+        });
+
+        std::vector<size_t> terminal_nt_codes;
+        std::vector<double> terminal_weights;
+
+        for (const auto& rule : cg.terminal_rules) {
+            terminal_nt_codes.push_back(rule.nt_code);
+            terminal_weights.push_back(rule.weight);
+        }
+
+        writer.writeSection(kTerminalNtCodes, terminal_nt_codes);
+        writer.writeSection(kTerminalWeights, terminal_weights);
+        writer.writeSection(kPairs, cg.pairs);
+        writer.writeSection(kHeads, cg.heads);
+        writer.writeSection(kHeadWeights, cg.head_weights);
+        writer.writeSection(kLeftOffsets, cg.left_offsets);
+        writer.writeSection(kPartnerRows, cg.partner_rows);
+        writer.writeSection(kRightPartners, cg.right_partners);
+        writer.writeSection(kBinaryHeads, cg.binary_heads);
+        CompiledGrammarSerializer::write(writer, cg.matcher);
+
+        auto& header = writer.header();
+        std::memcpy(header.magic, kCompiledGrammarMagic.data(), kCompiledGrammarMagic.size());
+        header.version = kFormatVersion;
+        header.byte_order = kByteOrderMark;
+        header.word_size = sizeof(size_t);
+        header.nt_count = cg.nt_count;
+        header.start_code = cg.start_code;
+        header.generates_empty = cg.generates_empty;
+        header.nt_words = cg.nt_words;
+
+        writer.flush(out);
+    }
+
+    void initCompiledGrammar(CompiledGrammar& cg, const MappedFile& file) {
+        const FileReader reader(file.view());
+        const auto& header = reader.header();
+
+        cg = CompiledGrammar{};
+        cg.nt_count = header.nt_count;
+        cg.start_code = header.start_code;
+        cg.generates_empty = header.generates_empty != 0;
+        cg.nt_words = header.nt_words;
+
+        reader.readArena(kNtNameOffsets, kNtNames, cg.nt_names, [](std::string& name, std::string value) {
+            name = std::move(value);
+        });
+        reader.readArena(kTerminalOffsets, kTerminals, cg.terminal_rules, [](auto& rule, std::string value) {
+            rule.terminal = std::move(value);
+        });
+
+        std::vector<size_t> terminal_nt_codes;
+        std::vector<double> terminal_weights;
+        reader.readSection(kTerminalNtCodes, terminal_nt_codes);
+        reader.readSection(kTerminalWeights, terminal_weights);
+
+        if (terminal_nt_codes.size() != cg.terminal_rules.size() || terminal_weights.size() != cg.terminal_rules.size()) {
+            throw std::runtime_error("the compiled grammar is corrupted.\n");
+        }
+
+        for (size_t i = 0; i < terminal_nt_codes.size(); ++i) {
+            cg.terminal_rules[i].nt_code = terminal_nt_codes[i];
+            cg.terminal_rules[i].weight = terminal_weights[i];
+        }
+
+        reader.readSection(kPairs, cg.pairs);
+        reader.readSection(kHeads, cg.heads);
+        reader.readSection(kHeadWeights, cg.head_weights);
+        reader.readSection(kLeftOffsets, cg.left_offsets);
+        reader.readSection(kPartnerRows, cg.partner_rows);
+        reader.readSection(kRightPartners, cg.right_partners);
+        reader.readSection(kBinaryHeads, cg.binary_heads);
+        CompiledGrammarSerializer::read(reader, cg.matcher);
+
+        if (!isConsistent(cg) || !CompiledGrammarSerializer::isValid(cg.matcher, cg.nt_count)) {
+            throw std::runtime_error("the compiled grammar is corrupted.\n");
+        }
+    }
+}  // namespace fl::algo
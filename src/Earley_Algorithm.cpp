@@ -0,0 +1,267 @@
+#include "Earley_Algorithm.h"
+
+#include "NonterminalCompression.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    using namespace fl;
+    using namespace fl::algo::earley;
+
+    /**
+     * The dot of an item is the index of the next symbol in EarleyGrammar::symbols,
+     * the item is complete when it reaches the end of the rule
+     */
+    struct Item {
+        size_t rule;
+        size_t dot;
+        size_t origin;
+
+        bool operator==(const Item& other) const noexcept {
+            return rule == other.rule && dot == other.dot && origin == other.origin;
+        }
+    };
+
+    struct ItemHash {
+        size_t operator()(const Item& item) const noexcept {
+            size_t h = item.rule;
+            h = h * 0x9e3779b97f4a7c15ull + item.dot;
+            h = h * 0x9e3779b97f4a7c15ull + item.origin;
+            return h ^ (h >> 29);
+        }
+    };
+
+    struct EarleySet {
+        std::vector<Item> items;
+        std::unordered_set<Item, ItemHash> seen;
+
+        // nt_code -> the indexes of the items that wait for the nonterminal
+        std::unordered_map<size_t, std::vector<size_t>> waiting;
+
+        void add(const Item& item) {
+            if (seen.insert(item).second) {
+                items.push_back(item);
+            }
+        }
+    };
+
+    class EarleyRecognizer {
+    public:
+        EarleyRecognizer(std::string_view text, const EarleyGrammar& eg)
+            : m_text(text)
+            , m_eg(eg)
+            , m_sets(text.size() + 1)
+            , m_predicted_at(eg.nt_count, kNotPredicted) {
+        }
+
+        bool run() {
+            for (size_t r = m_eg.rule_offsets[m_eg.start_code]; r < m_eg.rule_offsets[m_eg.start_code + 1]; ++r) {
+                m_sets[0].add({r, m_eg.rules[r].symbols_begin, 0});
+            }
+
+            for (size_t pos = 0; pos <= m_text.size(); ++pos) {
+                processSet(pos);
+            }
+
+            for (const auto& item : m_sets.back().items) {
+                const auto& rule = m_eg.rules[item.rule];
+
+                if (item.origin == 0 && rule.head == m_eg.start_code && item.dot == rule.symbols_end) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        static constexpr size_t kNotPredicted = static_cast<size_t>(-1);
+
+        void processSet(size_t pos) {
+            // The items are appended while the set is processed, so no iterators here
+            for (size_t i = 0; i < m_sets[pos].items.size(); ++i) {
+                const Item item = m_sets[pos].items[i];
+                const auto& rule = m_eg.rules[item.rule];
+
+                if (item.dot == rule.symbols_end) {
+                    complete(pos, rule.head, item.origin);
+                    continue;
+                }
+
+                const auto& symbol = m_eg.symbols[item.dot];
+
+                if (symbol.is_terminal) {
+                    scan(pos, item, m_eg.terminals[symbol.id]);
+                } else {
+                    m_sets[pos].waiting[symbol.id].push_back(i);
+                    predict(pos, item, symbol.id);
+                }
+            }
+        }
+
+        void scan(size_t pos, const Item& item, const std::string& terminal) {
+            if (pos + terminal.size() <= m_text.size() && m_text.compare(pos, terminal.size(), terminal) == 0) {
+                m_sets[pos + terminal.size()].add({item.rule, item.dot + 1, item.origin});
+            }
+        }
+
+        void predict(size_t pos, const Item& item, size_t nt_code) {
+            if (m_predicted_at[nt_code] != pos) {
+                m_predicted_at[nt_code] = pos;
+
+                for (size_t r = m_eg.rule_offsets[nt_code]; r < m_eg.rule_offsets[nt_code + 1]; ++r) {
+                    m_sets[pos].add({r, m_eg.rules[r].symbols_begin, pos});
+                }
+            }
+
+            // The nonterminal may generate the empty string right here,
+            // and such a completion would not see the items waiting for it later
+            if (m_eg.is_nullable[nt_code]) {
+                m_sets[pos].add({item.rule, item.dot + 1, item.origin});
+            }
+        }
+
+        void complete(size_t pos, size_t nt_code, size_t origin) {
+            auto& origin_set = m_sets[origin];
+            const auto it = origin_set.waiting.find(nt_code);
+
+            if (it == origin_set.waiting.end()) {
+                return;
+            }
+
+            // The list may grow while it is walked when origin == pos
+            for (size_t w = 0; w < it->second.size(); ++w) {
+                const Item waiting_item = origin_set.items[it->second[w]];
+                m_sets[pos].add({waiting_item.rule, waiting_item.dot + 1, waiting_item.origin});
+            }
+        }
+
+    private:
+        std::string_view m_text;
+        const EarleyGrammar& m_eg;
+        std::vector<EarleySet> m_sets;
+
+        // The last position where all the rules of the nonterminal were predicted
+        std::vector<size_t> m_predicted_at;
+    };
+}  // namespace
+
+namespace fl::algo::earley {
+    void initEarleyGrammar(EarleyGrammar& eg, const Grammar& g) {
+        eg = EarleyGrammar{};
+
+        if (g.multirules.empty()) {
+            return;
+        }
+
+        NonterminalTokenKeyTable nt_table;
+        initNonterminalTokenKeyTable(nt_table, g);
+
+        eg.nt_count = nt_table.size();
+        eg.start_code = nt_table[g.start];
+
+        std::map<std::string, size_t> terminal_ids;
+        std::vector<std::pair<size_t, std::vector<EarleyGrammar::Symbol>>> rules;
+
+        for (const auto& [nt_key, multirrs] : g.multirules) {
+            const size_t head = nt_table[nt_key];
+
+            for (const auto& rrs : multirrs) {
+                std::vector<EarleyGrammar::Symbol> rule_symbols;
+                std::string terminal;
+                size_t next_nt_index = 0;
+
+                auto flushTerminal = [&]() {
+                    if (terminal.empty()) {
+                        return;
+                    }
+
+                    const auto it = terminal_ids.emplace(terminal, terminal_ids.size()).first;
+                    rule_symbols.push_back({it->second, true});
+                    terminal.clear();
+                };
+
+                for (size_t i = 0; i < rrs.sequence.size(); ++i) {
+                    if (next_nt_index < rrs.nt_indexes.size() && rrs.nt_indexes[next_nt_index] == i) {
+                        flushTerminal();
+                        rule_symbols.push_back({nt_table[rrs.sequence[i]], false});
+                        ++next_nt_index;
+                    } else {
+                        terminal += g.tntable.token(rrs.sequence[i]);
+                    }
+                }
+
+                flushTerminal();
+                rules.emplace_back(head, std::move(rule_symbols));
+            }
+        }
+
+        std::stable_sort(rules.begin(), rules.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        eg.terminals.resize(terminal_ids.size());
+
+        for (auto& [terminal, id] : terminal_ids) {
+            eg.terminals[id] = terminal;
+        }
+
+        eg.rule_offsets.assign(eg.nt_count + 1, 0);
+
+        for (auto& [head, rule_symbols] : rules) {
+            eg.rules.push_back({head, eg.symbols.size(), eg.symbols.size() + rule_symbols.size()});
+            eg.symbols.insert(eg.symbols.end(), rule_symbols.begin(), rule_symbols.end());
+            ++eg.rule_offsets[head + 1];
+        }
+
+        for (size_t a = 0; a < eg.nt_count; ++a) {
+            eg.rule_offsets[a + 1] += eg.rule_offsets[a];
+        }
+
+        // A rule is nullable when all its symbols are nullable nonterminals
+        eg.is_nullable.assign(eg.nt_count, false);
+
+        for (bool is_changed = true; is_changed;) {
+            is_changed = false;
+
+            for (const auto& rule : eg.rules) {
+                if (eg.is_nullable[rule.head]) {
+                    continue;
+                }
+
+                const bool is_rule_nullable = std::all_of(eg.symbols.begin() + static_cast<ssize_t>(rule.symbols_begin),
+                                                          eg.symbols.begin() + static_cast<ssize_t>(rule.symbols_end),
+                                                          [&](const EarleyGrammar::Symbol& symbol) {
+                    return !symbol.is_terminal && eg.is_nullable[symbol.id];
+                });
+
+                if (is_rule_nullable) {
+                    eg.is_nullable[rule.head] = true;
+                    is_changed = true;
+                }
+            }
+        }
+    }
+
+    bool isRecognized(std::string_view text, const EarleyGrammar& eg) {
+        if (eg.empty()) {
+            return false;
+        }
+
+        if (text.empty()) {
+            return eg.is_nullable[eg.start_code];
+        }
+
+        return EarleyRecognizer(text, eg).run();
+    }
+
+    bool isRecognized(std::string_view text, const Grammar& g) {
+        EarleyGrammar eg;
+        initEarleyGrammar(eg, g);
+
+        return isRecognized(text, eg);
+    }
+}  // namespace fl::algo::earley
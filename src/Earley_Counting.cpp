@@ -0,0 +1,400 @@
+#include "Earley_Algorithm.h"
+
+#include <algorithm>
+#include <stack>
+
+namespace {
+    using namespace fl::algo;
+    using namespace fl::algo::earley;
+
+    using Value = CountingSemiring::Value;
+
+    // A graph over the nonterminals: the edges of A are edges[offsets[A]:offsets[A + 1]]
+    struct DependencyGraph {
+        struct Edge {
+            size_t target;
+            Value coefficient;
+        };
+
+        std::vector<size_t> offsets;
+        std::vector<Edge> edges;
+    };
+
+    /**
+     * The strongly connected components of the graph (Tarjan) in such an order
+     * that every component goes after all the components it has edges to,
+     * so the values can be computed component by component
+     */
+    std::vector<std::vector<size_t>> findComponents(const DependencyGraph& graph, size_t nt_count) {
+        static constexpr size_t kUnvisited = static_cast<size_t>(-1);
+
+        std::vector<std::vector<size_t>> components;
+        std::vector<size_t> order(nt_count, kUnvisited);
+        std::vector<size_t> low_link(nt_count, 0);
+        std::vector<bool> is_on_stack(nt_count, false);
+        std::vector<size_t> component_stack;
+        size_t visited_count = 0;
+
+        // (node, the next edge to follow)
+        std::stack<std::pair<size_t, size_t>> dfs_stack;
+
+        for (size_t root = 0; root < nt_count; ++root) {
+            if (order[root] != kUnvisited) {
+                continue;
+            }
+
+            dfs_stack.emplace(root, graph.offsets[root]);
+            order[root] = low_link[root] = visited_count++;
+            component_stack.push_back(root);
+            is_on_stack[root] = true;
+
+            while (!dfs_stack.empty()) {
+                auto& [node, edge] = dfs_stack.top();
+
+                if (edge < graph.offsets[node + 1]) {
+                    const size_t target = graph.edges[edge++].target;
+
+                    if (order[target] == kUnvisited) {
+                        order[target] = low_link[target] = visited_count++;
+                        component_stack.push_back(target);
+                        is_on_stack[target] = true;
+                        dfs_stack.emplace(target, graph.offsets[target]);
+                    } else if (is_on_stack[target]) {
+                        low_link[node] = std::min(low_link[node], order[target]);
+                    }
+
+                    continue;
+                }
+
+                const size_t finished = node;
+                dfs_stack.pop();
+
+                if (!dfs_stack.empty()) {
+                    const size_t parent = dfs_stack.top().first;
+                    low_link[parent] = std::min(low_link[parent], low_link[finished]);
+                }
+
+                if (low_link[finished] != order[finished]) {
+                    continue;
+                }
+
+                auto& component = components.emplace_back();
+
+                do {
+                    component.push_back(component_stack.back());
+                    is_on_stack[component_stack.back()] = false;
+                    component_stack.pop_back();
+                } while (component.back() != finished);
+            }
+        }
+
+        return components;
+    }
+
+    bool isCyclic(const std::vector<size_t>& component, const DependencyGraph& graph) {
+        if (component.size() > 1) {
+            return true;
+        }
+
+        const size_t node = component.front();
+
+        return std::any_of(graph.edges.begin() + static_cast<ssize_t>(graph.offsets[node]),
+                           graph.edges.begin() + static_cast<ssize_t>(graph.offsets[node + 1]),
+                           [node](const DependencyGraph::Edge& edge) {
+            return edge.target == node;
+        });
+    }
+
+    /**
+     * Counts the derivation trees of every substring by every nonterminal of the grammar
+     * as it is written. prefix(s, i, j) is the number of ways the symbols of a rule
+     * up to symbols[s] (included) derive text[i:j], the values of a nonterminal are
+     * the prefixes of its rules that reach the end.
+     *
+     * A derivation of text[i:j] by A may pass through another nonterminal B on the same
+     * substring when the rest of the rule of A is nullable. These dependencies do not
+     * depend on the substring: the value of A is c(A) + sum M(A, B) * value(B), where c(A)
+     * counts the derivations splitting text[i:j] between several symbols and M(A, B) counts
+     * the empty derivations of the rest of the rules. So the values are computed component
+     * by component of the graph of M, and a component with a cycle has either no
+     * derivations at all or infinitely many of them, which saturate the count.
+     * The empty derivations are computed the same way.
+     */
+    class DerivationCounter {
+    public:
+        DerivationCounter(std::string_view text, const EarleyGrammar& eg)
+            : m_text(text)
+            , m_eg(eg)
+            , m_spans_count((text.size() + 1) * (text.size() + 2) / 2)
+            , m_values(eg.nt_count * m_spans_count, CountingSemiring::zero())
+            , m_prefixes(eg.symbols.size() * m_spans_count, CountingSemiring::zero()) {
+        }
+
+        Value run() {
+            initEmptyValues();
+            initSpanGraph();
+
+            const size_t n = m_text.size();
+
+            for (size_t len = 1; len <= n; ++len) {
+                for (size_t begin = 0; begin + len <= n; ++begin) {
+                    fillSpan(begin, begin + len);
+                }
+            }
+
+            return value(m_eg.start_code, 0, n);
+        }
+
+    private:
+        // The spans text[i:j] with 0 <= i <= j <= n, the empty ones included
+        [[nodiscard]] size_t spanIndex(size_t begin, size_t end) const noexcept {
+            return end * (end + 1) / 2 + begin;
+        }
+
+        [[nodiscard]] Value& value(size_t nt_code, size_t begin, size_t end) noexcept {
+            return m_values[nt_code * m_spans_count + spanIndex(begin, end)];
+        }
+
+        [[nodiscard]] Value& prefix(size_t s, size_t begin, size_t end) noexcept {
+            return m_prefixes[s * m_spans_count + spanIndex(begin, end)];
+        }
+
+        // The prefix before symbols[s] of its rule, the empty prefix derives only the empty string
+        [[nodiscard]] Value previous(size_t s, size_t rule_begin, size_t begin, size_t end) noexcept {
+            if (s == rule_begin) {
+                return begin == end ? CountingSemiring::one() : CountingSemiring::zero();
+            }
+
+            return prefix(s - 1, begin, end);
+        }
+
+        void initEmptyValues() {
+            // A -> B when the rule of A consists of nullable nonterminals only
+            DependencyGraph graph;
+            graph.offsets.assign(m_eg.nt_count + 1, 0);
+
+            for (size_t a = 0; a < m_eg.nt_count; ++a) {
+                for (size_t r = m_eg.rule_offsets[a]; r < m_eg.rule_offsets[a + 1]; ++r) {
+                    const auto& rule = m_eg.rules[r];
+
+                    if (!isRuleNullable(rule)) {
+                        continue;
+                    }
+
+                    for (size_t s = rule.symbols_begin; s < rule.symbols_end; ++s) {
+                        graph.edges.push_back({m_eg.symbols[s].id, CountingSemiring::one()});
+                    }
+                }
+
+                graph.offsets[a + 1] = graph.edges.size();
+            }
+
+            m_empty_values.assign(m_eg.nt_count, CountingSemiring::zero());
+
+            for (const auto& component : findComponents(graph, m_eg.nt_count)) {
+                // All the nonterminals of a cycle are nullable, so they never stop deriving the empty string
+                if (isCyclic(component, graph)) {
+                    for (size_t a : component) {
+                        m_empty_values[a] = CountingSemiring::kSaturated;
+                    }
+
+                    continue;
+                }
+
+                const size_t a = component.front();
+
+                for (size_t r = m_eg.rule_offsets[a]; r < m_eg.rule_offsets[a + 1]; ++r) {
+                    const auto& rule = m_eg.rules[r];
+
+                    if (!isRuleNullable(rule)) {
+                        continue;
+                    }
+
+                    Value count = CountingSemiring::one();
+
+                    for (size_t s = rule.symbols_begin; s < rule.symbols_end; ++s) {
+                        count = CountingSemiring::times(count, m_empty_values[m_eg.symbols[s].id]);
+                    }
+
+                    m_empty_values[a] = CountingSemiring::plus(m_empty_values[a], count);
+                }
+            }
+
+            for (size_t pos = 0; pos <= m_text.size(); ++pos) {
+                for (size_t a = 0; a < m_eg.nt_count; ++a) {
+                    value(a, pos, pos) = m_empty_values[a];
+                }
+
+                for (const auto& rule : m_eg.rules) {
+                    for (size_t s = rule.symbols_begin; s < rule.symbols_end; ++s) {
+                        const auto& symbol = m_eg.symbols[s];
+                        const Value symbol_count = symbol.is_terminal ? CountingSemiring::zero() : m_empty_values[symbol.id];
+
+                        prefix(s, pos, pos) = CountingSemiring::times(previous(s, rule.symbols_begin, pos, pos), symbol_count);
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] bool isRuleNullable(const EarleyGrammar::Rule& rule) const {
+            return std::all_of(m_eg.symbols.begin() + static_cast<ssize_t>(rule.symbols_begin),
+                               m_eg.symbols.begin() + static_cast<ssize_t>(rule.symbols_end),
+                               [&](const EarleyGrammar::Symbol& symbol) {
+                return !symbol.is_terminal && m_eg.is_nullable[symbol.id];
+            });
+        }
+
+        // A -> B {M(A, B)} when a rule of A is B surrounded by the nullable nonterminals
+        void initSpanGraph() {
+            m_span_graph.offsets.assign(m_eg.nt_count + 1, 0);
+
+            for (size_t a = 0; a < m_eg.nt_count; ++a) {
+                for (size_t r = m_eg.rule_offsets[a]; r < m_eg.rule_offsets[a + 1]; ++r) {
+                    const auto& rule = m_eg.rules[r];
+
+                    for (size_t s = rule.symbols_begin; s < rule.symbols_end; ++s) {
+                        if (m_eg.symbols[s].is_terminal) {
+                            continue;
+                        }
+
+                        Value coefficient = CountingSemiring::one();
+
+                        for (size_t other = rule.symbols_begin; other < rule.symbols_end; ++other) {
+                            if (other == s) {
+                                continue;
+                            }
+
+                            const auto& symbol = m_eg.symbols[other];
+                            coefficient = CountingSemiring::times(coefficient,
+                                                                  symbol.is_terminal ? CountingSemiring::zero()
+                                                                                     : m_empty_values[symbol.id]);
+                        }
+
+                        if (coefficient != CountingSemiring::zero()) {
+                            m_span_graph.edges.push_back({m_eg.symbols[s].id, coefficient});
+                        }
+                    }
+                }
+
+                m_span_graph.offsets[a + 1] = m_span_graph.edges.size();
+            }
+
+            m_span_components = findComponents(m_span_graph, m_eg.nt_count);
+            m_span_constants.resize(m_eg.nt_count);
+        }
+
+        /**
+         * Computes prefix(s, begin, end) for all the symbols in the rule order,
+         * the values of the nonterminals on the same span are used only if they are ready.
+         * Returns the sum over the rules of A in m_span_constants[A].
+         */
+        void fillPrefixes(size_t begin, size_t end, bool are_values_ready) {
+            std::fill(m_span_constants.begin(), m_span_constants.end(), CountingSemiring::zero());
+
+            for (const auto& rule : m_eg.rules) {
+                for (size_t s = rule.symbols_begin; s < rule.symbols_end; ++s) {
+                    const auto& symbol = m_eg.symbols[s];
+                    Value count = CountingSemiring::zero();
+
+                    if (symbol.is_terminal) {
+                        const auto& terminal = m_eg.terminals[symbol.id];
+
+                        if (terminal.size() <= end - begin &&
+                            m_text.compare(end - terminal.size(), terminal.size(), terminal) == 0) {
+                            count = previous(s, rule.symbols_begin, begin, end - terminal.size());
+                        }
+                    } else {
+                        for (size_t mid = begin + 1; mid < end; ++mid) {
+                            const Value left = previous(s, rule.symbols_begin, begin, mid);
+
+                            if (left != CountingSemiring::zero()) {
+                                count = CountingSemiring::plus(count, CountingSemiring::times(left, value(symbol.id, mid, end)));
+                            }
+                        }
+
+                        count = CountingSemiring::plus(count,
+                                                       CountingSemiring::times(previous(s, rule.symbols_begin, begin, end),
+                                                                               m_empty_values[symbol.id]));
+
+                        if (are_values_ready) {
+                            count = CountingSemiring::plus(count,
+                                                           CountingSemiring::times(previous(s, rule.symbols_begin, begin, begin),
+                                                                                   value(symbol.id, begin, end)));
+                        }
+                    }
+
+                    prefix(s, begin, end) = count;
+                }
+
+                if (rule.symbols_begin != rule.symbols_end) {
+                    Value& constant = m_span_constants[rule.head];
+                    constant = CountingSemiring::plus(constant, prefix(rule.symbols_end - 1, begin, end));
+                }
+            }
+        }
+
+        void fillSpan(size_t begin, size_t end) {
+            fillPrefixes(begin, end, false);
+
+            for (const auto& component : m_span_components) {
+                const bool is_cyclic = isCyclic(component, m_span_graph);
+                Value component_count = CountingSemiring::zero();
+
+                for (size_t a : component) {
+                    Value count = m_span_constants[a];
+
+                    for (size_t e = m_span_graph.offsets[a]; e < m_span_graph.offsets[a + 1]; ++e) {
+                        const auto& edge = m_span_graph.edges[e];
+
+                        // The values inside a cycle are not ready, they are decided below
+                        if (is_cyclic && std::find(component.begin(), component.end(), edge.target) != component.end()) {
+                            continue;
+                        }
+
+                        count = CountingSemiring::plus(count,
+                                                       CountingSemiring::times(edge.coefficient, value(edge.target, begin, end)));
+                    }
+
+                    value(a, begin, end) = count;
+                    component_count = CountingSemiring::plus(component_count, count);
+                }
+
+                if (is_cyclic && component_count != CountingSemiring::zero()) {
+                    for (size_t a : component) {
+                        value(a, begin, end) = CountingSemiring::kSaturated;
+                    }
+                }
+            }
+
+            fillPrefixes(begin, end, true);
+        }
+
+    private:
+        std::string_view m_text;
+        const EarleyGrammar& m_eg;
+        size_t m_spans_count;
+        std::vector<Value> m_values;
+        std::vector<Value> m_prefixes;
+        std::vector<Value> m_empty_values;
+        DependencyGraph m_span_graph;
+        std::vector<std::vector<size_t>> m_span_components;
+        std::vector<Value> m_span_constants;
+    };
+}  // namespace
+
+namespace fl::algo::earley {
+    CountingSemiring::Value countDerivations(std::string_view text, const EarleyGrammar& eg) {
+        if (eg.empty()) {
+            return CountingSemiring::zero();
+        }
+
+        return DerivationCounter(text, eg).run();
+    }
+
+    CountingSemiring::Value countDerivations(std::string_view text, const Grammar& g) {
+        EarleyGrammar eg;
+        initEarleyGrammar(eg, g);
+
+        return countDerivations(text, eg);
+    }
+}  // namespace fl::algo::earley
@@ -4,6 +4,7 @@
 #include <queue>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
 #include <cassert>
 
@@ -53,6 +54,12 @@ namespace {
 
         return res;
     }
+
+    void outputRuleWeight(std::ostream& out, const fl::RuleRightSide& rrs) {
+        if (rrs.weight) {
+            out << "{" << *rrs.weight << "} ";
+        }
+    }
 }  // namespace
 
 namespace fl {
@@ -76,56 +83,232 @@ namespace fl {
         ref = ref | type;
     }
 
-    TokenKey TokenTable::insert(std::string&& s, TokenType type) {
+    TokenKey TokenTable::insert(std::string_view s, TokenType type) {
         // todo: assert for TokenType
-        auto it1 = rtable.find(s);
+        const size_t hash = std::hash<std::string_view>{}(s);
+
+        if (!m_slots.empty()) {
+            const TokenKey key = m_slots[findSlot(s, hash)];
 
-        if (it1 != rtable.end()) {
-            // todo: question of guarantee about given type and table[it1->second].type
-            if (type == TokenType::kNonterminal) {
-                ++nt_count;
+            if (key != kEmptySlot) {
+                // todo: question of guarantee about given type and table[key].type
+                if ((type & TokenType::kNonterminal) != TokenType::kNothing &&
+                    (m_entries[key].type & TokenType::kNonterminal) == TokenType::kNothing) {
+                    ++m_nt_count;
+                }
+
+                assignOr(m_entries[key].type, type);
+                return key;
             }
-            assignOr(table[it1->second].type, type);
-            return it1->second;
         }
 
-        if (type == TokenType::kNonterminal) {
-            ++nt_count;
+        // The index is kept at most half full, so the probe sequences stay short
+        if ((m_tokens_count + 1) * 2 > m_slots.size()) {
+            rehash(std::max<size_t>(16, m_slots.size() * 2));
         }
 
-        assert(table.size() == rtable.size());
-        auto it2 = table.emplace(table.size(), TableEntry{std::move(s), type}).first;
-
-        rtable.emplace(it2->second.token, rtable.size());
-        assert(table.size() == rtable.size());
+        if ((type & TokenType::kNonterminal) != TokenType::kNothing) {
+            ++m_nt_count;
+        }
 
+        const TokenKey key = m_entries.size();
+        m_entries.push_back(Entry{m_arena.size(), s.size(), hash, type});
+        m_arena.append(s);
+        m_slots[findSlot(s, hash)] = key;
+        ++m_tokens_count;
 
-        return it2->first;
+        return key;
     }
 
     void TokenTable::erase(TokenKey key, TokenType type) {
-        auto it = table.find(key);
+        auto& entry = m_entries.at(key);
 
-        // todo: assert for it->second.type >=(bitwise) type
+        // todo: assert for entry.type >=(bitwise) type
 
         if ((type & TokenType::kNonterminal) != TokenType::kNothing) {
-            assert(it->second.type & TokenType::kNonterminal);
-            --nt_count;
+            assert((entry.type & TokenType::kNonterminal) != TokenType::kNothing);
+            --m_nt_count;
         }
 
-        assignXor(it->second.type, type);
+        assignXor(entry.type, type);
 
-        if (it->second.type != TokenType::kNothing) {
+        if (entry.type != TokenType::kNothing) {
             return;
         }
 
-        rtable.erase(it->second.token);
-        table.erase(it);
+        // The string stays in the arena until the table is cleared
+        eraseSlot(findSlot(entryToken(entry), entry.hash));
+        --m_tokens_count;
     }
 
     void TokenTable::clear() noexcept {
-        table.clear();
-        rtable.clear();
+        m_entries.clear();
+        m_arena.clear();
+        m_slots.clear();
+        m_tokens_count = 0;
+        m_nt_count = 0;
+    }
+
+    std::optional<TokenKey> TokenTable::find(std::string_view s) const {
+        if (m_slots.empty()) {
+            return std::nullopt;
+        }
+
+        const TokenKey key = m_slots[findSlot(s, std::hash<std::string_view>{}(s))];
+
+        if (key == kEmptySlot) {
+            return std::nullopt;
+        }
+
+        return key;
+    }
+
+    std::string_view TokenTable::token(TokenKey key) const {
+        const auto& entry = m_entries.at(key);
+
+        if (entry.type == TokenType::kNothing) {
+            throw std::out_of_range("TokenTable::token got an erased key");
+        }
+
+        return entryToken(entry);
+    }
+
+    TokenType TokenTable::type(TokenKey key) const {
+        return m_entries.at(key).type;
+    }
+
+    std::string_view TokenTable::entryToken(const Entry& entry) const noexcept {
+        return std::string_view(m_arena).substr(entry.offset, entry.size);
+    }
+
+    // Returns the slot of the token s or the empty slot where s would be placed
+    size_t TokenTable::findSlot(std::string_view s, size_t hash) const noexcept {
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = hash & mask;
+
+        while (m_slots[slot] != kEmptySlot) {
+            const Entry& entry = m_entries[m_slots[slot]];
+
+            if (entry.hash == hash && entryToken(entry) == s) {
+                break;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+
+        return slot;
+    }
+
+    // Linear probing without tombstones: the following entries of the cluster are shifted back
+    // into the freed slot, unless their home slot lies after it
+    void TokenTable::eraseSlot(size_t slot) noexcept {
+        const size_t mask = m_slots.size() - 1;
+        size_t next = slot;
+
+        while (true) {
+            next = (next + 1) & mask;
+
+            if (m_slots[next] == kEmptySlot) {
+                break;
+            }
+
+            const size_t home = m_entries[m_slots[next]].hash & mask;
+
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                m_slots[slot] = m_slots[next];
+                slot = next;
+            }
+        }
+
+        m_slots[slot] = kEmptySlot;
+    }
+
+    void TokenTable::rehash(size_t slots_count) {
+        m_slots.assign(slots_count, kEmptySlot);
+
+        for (TokenKey key = 0; key < m_entries.size(); ++key) {
+            const Entry& entry = m_entries[key];
+
+            if (entry.type != TokenType::kNothing) {
+                m_slots[findSlot(entryToken(entry), entry.hash)] = key;
+            }
+        }
+    }
+
+    MultirulesMap& MultirulesMap::operator=(const MultirulesMap& other) {
+        // The slots hold a const key, so the deque is copied as a whole
+        MultirulesMap copy(other);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    MultirulesMap& MultirulesMap::operator=(MultirulesMap&& other) noexcept {
+        m_slots.swap(other.m_slots);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    MultirulesMap::iterator MultirulesMap::find(TokenKey key) {
+        if (key >= m_slots.size() || !m_slots[key]) {
+            return end();
+        }
+
+        return {this, key};
+    }
+
+    MultirulesMap::const_iterator MultirulesMap::find(TokenKey key) const {
+        if (key >= m_slots.size() || !m_slots[key]) {
+            return end();
+        }
+
+        return {this, key};
+    }
+
+    MultiruleRightSide& MultirulesMap::at(TokenKey key) {
+        if (key >= m_slots.size() || !m_slots[key]) {
+            throw std::out_of_range("MultirulesMap::at got a key without right sides");
+        }
+
+        return m_slots[key]->second;
+    }
+
+    const MultiruleRightSide& MultirulesMap::at(TokenKey key) const {
+        if (key >= m_slots.size() || !m_slots[key]) {
+            throw std::out_of_range("MultirulesMap::at got a key without right sides");
+        }
+
+        return m_slots[key]->second;
+    }
+
+    MultiruleRightSide& MultirulesMap::operator[](TokenKey key) {
+        return try_emplace(key).first->second;
+    }
+
+    std::pair<MultirulesMap::iterator, bool> MultirulesMap::try_emplace(TokenKey key) {
+        if (key >= m_slots.size()) {
+            m_slots.resize(key + 1);
+        }
+
+        if (m_slots[key]) {
+            return {{this, key}, false};
+        }
+
+        m_slots[key].emplace(key, MultiruleRightSide{});
+        ++m_size;
+
+        return {{this, key}, true};
+    }
+
+    MultirulesMap::iterator MultirulesMap::erase(iterator it) {
+        m_slots[it.m_index].reset();
+        --m_size;
+
+        return ++it;
+    }
+
+    void MultirulesMap::clear() noexcept {
+        m_slots.clear();
+        m_size = 0;
     }
 
     void RuleRightSide::pushTerminal(const TokenKey key) {
@@ -139,21 +322,21 @@ namespace fl {
 
     bool isRuleRightSidesEqual(const RuleRightSide& a,
                                const RuleRightSide& b,
-                               const TokenTable::Table& a_table,
-                               const TokenTable::Table& b_table) {
+                               const TokenTable& a_table,
+                               const TokenTable& b_table) {
         if (a.nt_indexes != b.nt_indexes || a.sequence.size() != b.sequence.size()) {
             return false;
         }
 
         for (size_t nt_ind : a.nt_indexes) {
-            if (a_table.at(a.sequence[nt_ind]).token != b_table.at(b.sequence[nt_ind]).token) {
+            if (a_table.token(a.sequence[nt_ind]) != b_table.token(b.sequence[nt_ind])) {
                 return false;
             }
         }
 
         if (a.nt_indexes.empty()) {
             for (ssize_t i = 0; i < a.sequence.size(); ++i) {
-                if (a_table.at(a.sequence[i]).token != b_table.at(b.sequence[i]).token) {
+                if (a_table.token(a.sequence[i]) != b_table.token(b.sequence[i])) {
                     return false;
                 }
             }
@@ -162,21 +345,21 @@ namespace fl {
         }
 
         for (ssize_t i = 0; i < a.nt_indexes[0]; ++i) {
-            if (a_table.at(a.sequence[i]).token != a_table.at(b.sequence[i]).token) {
+            if (a_table.token(a.sequence[i]) != b_table.token(b.sequence[i])) {
                 return false;
             }
         }
 
         for (ssize_t i = 1; i < a.nt_indexes.size(); ++i) {
             for (ssize_t j = static_cast<ssize_t>(a.nt_indexes[i - 1]) + 1; j < a.nt_indexes[i]; ++j) {
-                if (a_table.at(a.sequence[j]).token != b_table.at(b.sequence[j]).token) {
+                if (a_table.token(a.sequence[j]) != b_table.token(b.sequence[j])) {
                     return false;
                 }
             }
         }
 
         for (ssize_t i = static_cast<ssize_t>(a.nt_indexes.back()) + 1; i < a.sequence.size(); ++i) {
-            if (a_table.at(a.sequence[i]).token != b_table.at(b.sequence[i]).token) {
+            if (a_table.token(a.sequence[i]) != b_table.token(b.sequence[i])) {
                 return false;
             }
         }
@@ -187,33 +370,36 @@ namespace fl {
     // TODO: escape sequences are not handled
     void outputRuleRightSide(std::ostream& out,
                              const RuleRightSide& rrs,
-                             const TokenTable::Table& table) {
+                             const TokenTable& table) {
         const bool has_nt_indexes = !rrs.nt_indexes.empty();
         const size_t prefix_size = !has_nt_indexes ? rrs.sequence.size() : rrs.nt_indexes.front();
 
         for (ssize_t i = 0; i < prefix_size; ++i) {
-            out << "\"" << table.at(rrs.sequence[i]).token << "\" ";
+            out << "\"" << table.token(rrs.sequence[i]) << "\" ";
         }
 
         if (!has_nt_indexes) {
+            outputRuleWeight(out, rrs);
             return;
         }
 
         for (ssize_t i = 1; i < rrs.nt_indexes.size(); ++i) {
-            out << table.at(rrs.sequence[rrs.nt_indexes[i - 1]]).token << " ";
+            out << table.token(rrs.sequence[rrs.nt_indexes[i - 1]]) << " ";
 
             for (ssize_t j = static_cast<ssize_t>(rrs.nt_indexes[i - 1]) + 1; j < rrs.nt_indexes[i]; ++j) {
-                out << "\"" << table.at(rrs.sequence[j]).token << "\" ";
+                out << "\"" << table.token(rrs.sequence[j]) << "\" ";
             }
         }
 
-        out << table.at(rrs.sequence[rrs.nt_indexes.back()]).token << " ";
+        out << table.token(rrs.sequence[rrs.nt_indexes.back()]) << " ";
 
         // todo: maybe handle excessive space?
 
         for (ssize_t i = static_cast<ssize_t>(rrs.nt_indexes.back()) + 1; i < rrs.sequence.size(); ++i) {
-            out << "\"" << table.at(rrs.sequence[i]).token << "\" ";
+            out << "\"" << table.token(rrs.sequence[i]) << "\" ";
         }
+
+        outputRuleWeight(out, rrs);
     }
 
     GrammarInputException::GrammarInputException(const char* message)
@@ -251,7 +437,7 @@ namespace fl {
             g.start = m_cur_nt_key;
         }
 
-        g.multirules.insert({m_cur_nt_key, {}});
+        g.multirules.try_emplace(m_cur_nt_key);
     }
 
     void GrammarBuilder::addRuleRightSide() {
@@ -275,6 +461,10 @@ namespace fl {
         }
     }
 
+    void GrammarBuilder::setRuleWeight(double weight) {
+        m_g.get().multirules[m_cur_nt_key].back().weight = weight;
+    }
+
     Grammar&& GrammarBuilder::getGrammar() && {
         if (m_owned_g.has_value()) {
             return std::move(*m_owned_g);
@@ -290,8 +480,14 @@ namespace fl {
 
         for (auto& multirule : a.multirules) {
             const auto& a_multirrs = multirule.second;
-            const auto& a_multirule_token = a.tntable.table.at(multirule.first).token;
-            const auto& b_multirrs = b.multirules.at(b.tntable.rtable.at(a_multirule_token));
+            const auto a_multirule_token = a.tntable.token(multirule.first);
+            const auto b_multirule_key = b.tntable.find(a_multirule_token);
+
+            if (!b_multirule_key || b.multirules.find(*b_multirule_key) == b.multirules.end()) {
+                return false;
+            }
+
+            const auto& b_multirrs = b.multirules.at(*b_multirule_key);
 
             if (a_multirrs.size() != b_multirrs.size()) {
                 return false;
@@ -300,8 +496,8 @@ namespace fl {
             for (ssize_t i = 0; i < a_multirrs.size(); ++i) {
                 if (!isRuleRightSidesEqual(a_multirrs[i],
                                            b_multirrs[i],
-                                           a.tntable.table,
-                                           b.tntable.table)) {
+                                           a.tntable,
+                                           b.tntable)) {
                     return false;
                 }
             }
@@ -338,7 +534,8 @@ namespace fl {
         enum class LastToken {
             kNothing,
             kNonterminal,
-            kTerminal
+            kTerminal,
+            kWeight
         };
 
         g.clear();
@@ -418,6 +615,43 @@ namespace fl {
                     continue;
                 }
 
+                if (last_token == LastToken::kWeight) {
+                    throw GrammarInputException("a weight must be the last one in the right side of a rule.\n");
+                }
+
+                if (s[r] == '{') {
+                    if (!is_rule_right_side || last_token == LastToken::kNothing) {
+                        throw GrammarInputException("a weight can only follow the right side of a rule.\n");
+                    }
+
+                    l = r;
+                    r = s.find('}', r + 1);
+
+                    if (r == std::string::npos) {
+                        throw GrammarInputException("every weight in {}-braces must be closed in the same line.\n");
+                    }
+
+                    if (last_token == LastToken::kTerminal) {
+                        flushTerminalBuffer();
+                    }
+
+                    try {
+                        size_t parsed_size = 0;
+                        const std::string weight = s.substr(l + 1, r - l - 1);
+                        builder.setRuleWeight(std::stod(weight, &parsed_size));
+
+                        if (weight.find_first_not_of(' ', parsed_size) != std::string::npos) {
+                            throw std::invalid_argument("trailing symbols");
+                        }
+                    }
+                    catch (std::logic_error&) {
+                        throw GrammarInputException("a weight in {}-braces must be a number.\n");
+                    }
+
+                    last_token = LastToken::kWeight;
+                    continue;
+                }
+
                 if (s[r] == '"') {
                     l = r;
                     r = findTerminalEnd(r + 1, s);
@@ -480,7 +714,7 @@ namespace fl {
         std::queue<TokenKey> bfs_queue;
         std::set<TokenKey> shown;
         TokenKey cur;
-        const auto& table = g.tntable.table;
+        const auto& table = g.tntable;
 
         for (const auto& multirule : g.multirules) {
             if (shown.find(multirule.first) != shown.end()) {
@@ -494,7 +728,7 @@ namespace fl {
                 cur = bfs_queue.front();
                 bfs_queue.pop();
     
-                out << table.at(cur).token << "\n";
+                out << table.token(cur) << "\n";
 
                 const auto& multirrs = g.multirules.find(cur)->second;
 
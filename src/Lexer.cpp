@@ -0,0 +1,69 @@
+#include "Lexer.h"
+
+namespace fl::algo {
+    bool tokenize(std::string_view text, const CompiledGrammar& cg, std::vector<TerminalMatcher::State>& tokens) {
+        using State = TerminalMatcher::State;
+
+        const auto& matcher = cg.matcher;
+        size_t pos = 0;
+
+        tokens.clear();
+
+        while (pos < text.size()) {
+            State longest_state = TerminalMatcher::kNoState;
+            size_t longest_end = pos;
+            State state = TerminalMatcher::root();
+
+            for (size_t end = pos; end < text.size(); ++end) {
+                state = matcher.child(state, text[end]);
+
+                if (state == TerminalMatcher::kNoState) {
+                    break;
+                }
+
+                bool is_terminal = false;
+                matcher.forEachExactMatch(state, [&is_terminal](size_t, size_t) {
+                    is_terminal = true;
+                });
+
+                if (is_terminal) {
+                    longest_state = state;
+                    longest_end = end + 1;
+                }
+            }
+
+            if (longest_state == TerminalMatcher::kNoState) {
+                return false;
+            }
+
+            tokens.push_back(longest_state);
+            pos = longest_end;
+        }
+
+        return true;
+    }
+
+    std::optional<size_t> findSymbolMatches(std::string_view text,
+                                            const CompiledGrammar& cg,
+                                            const RecognitionOptions& options,
+                                            const TerminalMatchCallback& on_match) {
+        if (!options.is_token_level) {
+            findTerminalMatches(text, cg, on_match);
+            return text.size();
+        }
+
+        std::vector<TerminalMatcher::State> tokens;
+
+        if (!tokenize(text, cg, tokens)) {
+            return std::nullopt;
+        }
+
+        for (size_t pos = 0; pos < tokens.size(); ++pos) {
+            cg.matcher.forEachExactMatch(tokens[pos], [&](size_t, size_t nt_code) {
+                on_match(pos, 1, nt_code);
+            });
+        }
+
+        return tokens.size();
+    }
+}  // namespace fl::algo
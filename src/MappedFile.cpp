@@ -0,0 +1,90 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace fl {
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "failed to open " + path.string());
+        }
+
+        struct stat file_stat{};
+
+        if (::fstat(fd, &file_stat) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "failed to stat " + path.string());
+        }
+
+        m_size = static_cast<size_t>(file_stat.st_size);
+
+        if (m_size != 0) {
+            void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (addr == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "failed to map " + path.string());
+            }
+
+            m_data = static_cast<const char*>(addr);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0)) {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (m_data != nullptr) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    TextInput::TextInput(const std::filesystem::path& path) {
+        if (std::filesystem::is_regular_file(path)) {
+            m_file = MappedFile(path);
+            return;
+        }
+
+        std::ifstream fin(path, std::ios::binary);
+
+        if (!fin.good()) {
+            throw std::system_error(errno, std::generic_category(), "failed to open " + path.string());
+        }
+
+        m_buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+}  // namespace fl
@@ -2,16 +2,17 @@
 
 namespace fl::algo {
     void initNonterminalTokenKeyTable(NonterminalTokenKeyTable& nt_table, const Grammar& g) {
-        nt_table.reserve(g.tntable.nt_count);
+        nt_table.m_codes.assign(g.tntable.keysEnd(), NonterminalTokenKeyTable::kNoCode);
+        nt_table.m_keys.clear();
+        nt_table.m_keys.reserve(g.tntable.ntCount());
 
-        size_t nonterminal_count = 0;
-
-        for (const auto& [key, entry] : g.tntable.table) {
-            if ((entry.type & TokenType::kNonterminal) == TokenType::kNothing) {
+        for (TokenKey key = 0; key < g.tntable.keysEnd(); ++key) {
+            if ((g.tntable.type(key) & TokenType::kNonterminal) == TokenType::kNothing) {
                 continue;
             }
 
-            nt_table[key] = nonterminal_count++;
+            nt_table.m_codes[key] = nt_table.m_keys.size();
+            nt_table.m_keys.push_back(key);
         }
     }
 }  // namespace fl::algo
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Statistics.h"
+
+namespace fl::algo {
+    void printStatistics(std::ostream& out, const Statistics& stats) {
+        const char* separator = "";
+
+        out << "{";
+
+        if (stats.conversion) {
+            out << "\n  \"conversion\": {\n    \"passes\": [";
+
+            const char* pass_separator = "";
+
+            for (const auto& pass : stats.conversion->passes) {
+                // The names of the passes are identifiers, they need no escaping
+                out << pass_separator << "\n      {"
+                    << "\"name\": \"" << pass.name << "\", "
+                    << "\"skipped\": " << (pass.is_skipped ? "true" : "false") << ", "
+                    << "\"seconds\": " << pass.seconds << ", "
+                    << "\"nonterminals_before\": " << pass.nonterminals_before << ", "
+                    << "\"nonterminals_after\": " << pass.nonterminals_after << ", "
+                    << "\"rules_before\": " << pass.rules_before << ", "
+                    << "\"rules_after\": " << pass.rules_after << "}";
+                pass_separator = ",";
+            }
+
+            out << "\n    ]\n  }";
+            separator = ",";
+        }
+
+        if (stats.recognition) {
+            const auto& recognition = *stats.recognition;
+
+            out << separator << "\n  \"recognition\": {"
+                << "\"init_seconds\": " << recognition.init_seconds << ", "
+                << "\"fill_seconds\": " << recognition.fill_seconds << ", "
+                << "\"chart_bytes\": " << recognition.chart_bytes << ", "
+                << "\"cells_touched\": " << recognition.cells_touched << "}";
+        }
+
+        out << "\n}\n";
+    }
+}  // namespace fl::algo
@@ -0,0 +1,116 @@
+#include "StreamRecognition.h"
+
+#include <thread>
+
+namespace {
+    // Below that the records of a block are not worth a task
+    constexpr size_t kMinRecordsPerTask = 16;
+}  // namespace
+
+namespace logic {
+    bool StreamBlockQueue::push(StreamBlock&& block) {
+        std::unique_lock lock(m_mutex);
+        m_not_full_cv.wait(lock, [this] { return m_is_closed || m_blocks.size() < kStreamQueuedBlocks; });
+
+        if (m_is_closed) {
+            return false;
+        }
+
+        m_blocks.push_back(std::move(block));
+        m_not_empty_cv.notify_one();
+
+        return true;
+    }
+
+    StreamBlock StreamBlockQueue::pop() {
+        std::unique_lock lock(m_mutex);
+        m_not_empty_cv.wait(lock, [this] { return !m_blocks.empty(); });
+        StreamBlock block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        m_not_full_cv.notify_one();
+
+        return block;
+    }
+
+    void StreamBlockQueue::close() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_is_closed = true;
+            m_blocks.clear();
+        }
+
+        m_not_full_cv.notify_all();
+    }
+
+    void readStreamBlocks(std::istream& in, char delimiter, StreamBlockQueue& queue) {
+        for (bool is_last = false; !is_last;) {
+            StreamBlock block;
+            std::string record;
+
+            while (block.records.size() < kStreamBlockSize) {
+                if (!std::getline(in, record, delimiter)) {
+                    block.is_last = true;
+                    break;
+                }
+
+                block.records.push_back(std::move(record));
+
+                if (in.rdbuf()->in_avail() <= 0) {
+                    break;
+                }
+            }
+
+            is_last = block.is_last;
+
+            if (!queue.push(std::move(block))) {
+                return;
+            }
+        }
+    }
+
+    void recognizeStream(std::istream& in,
+                         std::ostream& out,
+                         char delimiter,
+                         fl::algo::ThreadPool& pool,
+                         const std::function<bool(std::string_view text)>& recognize) {
+        StreamBlockQueue queue;
+
+        // The next blocks are read while the current one is recognized
+        std::thread reader(readStreamBlocks, std::ref(in), delimiter, std::ref(queue));
+
+        std::vector<char> results;
+        std::string output;
+
+        try {
+            for (bool is_last = false; !is_last;) {
+                StreamBlock block = queue.pop();
+                is_last = block.is_last;
+
+                results.assign(block.records.size(), false);
+
+                pool.parallelFor(block.records.size(), kMinRecordsPerTask, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        results[i] = recognize(block.records[i]);
+                    }
+                });
+
+                output.clear();
+
+                for (char is_recognized : results) {
+                    output += is_recognized ? "Yes\n" : "No\n";
+                }
+
+                out.write(output.data(), static_cast<std::streamsize>(output.size()));
+                out.flush();
+            }
+        }
+        catch (...) {
+            // A joinable thread must not be destroyed
+            queue.close();
+            reader.join();
+            throw;
+        }
+
+        reader.join();
+    }
+}  // namespace logic
@@ -0,0 +1,160 @@
+#include "TerminalMatcher.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+
+namespace fl::algo {
+    void TerminalMatcher::clear() noexcept {
+        m_pending.clear();
+        m_nodes.clear();
+        m_edges.clear();
+        m_patterns.clear();
+        m_nt_codes.clear();
+        m_prefix_nt_codes.clear();
+    }
+
+    void TerminalMatcher::addPattern(const std::string& terminal, size_t nt_code) {
+        if (!terminal.empty()) {
+            m_pending.emplace_back(terminal, nt_code);
+        }
+    }
+
+    void TerminalMatcher::build() {
+        // Phase 1: build the trie with ordered children, so that the edges can be flattened
+        std::vector<std::map<char, State>> children(1);
+        std::vector<size_t> node_patterns(1, kNoPattern);
+
+        std::sort(m_pending.begin(), m_pending.end());
+        m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+        for (const auto& [terminal, nt_code] : m_pending) {
+            State state = root();
+
+            for (char ch : terminal) {
+                auto it = children[state].find(ch);
+
+                if (it == children[state].end()) {
+                    it = children[state].emplace(ch, static_cast<State>(children.size())).first;
+                    children.emplace_back();
+                    node_patterns.push_back(kNoPattern);
+                }
+
+                state = it->second;
+            }
+
+            // The pending terminals are sorted, so equal terminals come one after another
+            if (node_patterns[state] == kNoPattern) {
+                node_patterns[state] = m_patterns.size();
+                m_patterns.push_back({terminal.size(), m_nt_codes.size(), m_nt_codes.size()});
+            }
+
+            m_nt_codes.push_back(nt_code);
+            ++m_patterns[node_patterns[state]].nt_codes_end;
+        }
+
+        m_pending.clear();
+        m_pending.shrink_to_fit();
+
+        m_nodes.assign(children.size(), Node{});
+        m_edges.clear();
+
+        for (size_t state = 0; state < children.size(); ++state) {
+            m_nodes[state].edges_begin = m_edges.size();
+
+            for (const auto& [ch, target] : children[state]) {
+                m_edges.push_back({ch, target});
+            }
+
+            m_nodes[state].edges_end = m_edges.size();
+            m_nodes[state].pattern = node_patterns[state];
+        }
+
+        // Phase 2: failure and output links in BFS order
+        std::queue<State> bfs_queue;
+
+        for (size_t e = m_nodes[root()].edges_begin; e < m_nodes[root()].edges_end; ++e) {
+            m_nodes[m_edges[e].target].fail = root();
+            bfs_queue.push(m_edges[e].target);
+        }
+
+        while (!bfs_queue.empty()) {
+            const State cur = bfs_queue.front();
+            bfs_queue.pop();
+
+            for (size_t e = m_nodes[cur].edges_begin; e < m_nodes[cur].edges_end; ++e) {
+                const auto [ch, target] = m_edges[e];
+                const State fail = next(m_nodes[cur].fail, ch);
+                auto& node = m_nodes[target];
+
+                node.fail = fail;
+                node.output = m_nodes[fail].pattern != kNoPattern ? fail : m_nodes[fail].output;
+                bfs_queue.push(target);
+            }
+        }
+
+        // Phase 3: the nonterminals of the terminals in every subtree, children go before parents.
+        // A child is always created after its parent and the edges are flattened in the order
+        // of their sources, so the targets of the edges list every node after its parent
+        std::vector<State> parents_first = {root()};
+        std::vector<std::vector<size_t>> subtree_nt_codes(m_nodes.size());
+
+        for (const auto& edge : m_edges) {
+            parents_first.push_back(edge.target);
+        }
+
+        for (size_t i = parents_first.size(); i-- > 0;) {
+            const State state = parents_first[i];
+            auto& nt_codes = subtree_nt_codes[state];
+
+            if (m_nodes[state].pattern != kNoPattern) {
+                const auto& pattern = m_patterns[m_nodes[state].pattern];
+                nt_codes.insert(nt_codes.end(),
+                                m_nt_codes.begin() + static_cast<ssize_t>(pattern.nt_codes_begin),
+                                m_nt_codes.begin() + static_cast<ssize_t>(pattern.nt_codes_end));
+            }
+
+            for (size_t e = m_nodes[state].edges_begin; e < m_nodes[state].edges_end; ++e) {
+                auto& child_nt_codes = subtree_nt_codes[m_edges[e].target];
+                nt_codes.insert(nt_codes.end(), child_nt_codes.begin(), child_nt_codes.end());
+            }
+
+            std::sort(nt_codes.begin(), nt_codes.end());
+            nt_codes.erase(std::unique(nt_codes.begin(), nt_codes.end()), nt_codes.end());
+        }
+
+        for (size_t state = 0; state < m_nodes.size(); ++state) {
+            m_nodes[state].prefix_nt_codes_begin = m_prefix_nt_codes.size();
+            m_prefix_nt_codes.insert(m_prefix_nt_codes.end(),
+                                     subtree_nt_codes[state].begin(),
+                                     subtree_nt_codes[state].end());
+            m_nodes[state].prefix_nt_codes_end = m_prefix_nt_codes.size();
+        }
+    }
+
+    TerminalMatcher::State TerminalMatcher::child(State state, char ch) const noexcept {
+        const auto begin = m_edges.begin() + static_cast<ssize_t>(m_nodes[state].edges_begin);
+        const auto end = m_edges.begin() + static_cast<ssize_t>(m_nodes[state].edges_end);
+        const auto it = std::lower_bound(begin, end, ch, [](const Edge& edge, char c) {
+            return edge.ch < c;
+        });
+
+        return it != end && it->ch == ch ? it->target : kNoState;
+    }
+
+    TerminalMatcher::State TerminalMatcher::next(State state, char ch) const noexcept {
+        while (true) {
+            const State target = child(state, ch);
+
+            if (target != kNoState) {
+                return target;
+            }
+
+            if (state == root()) {
+                return root();
+            }
+
+            state = m_nodes[state].fail;
+        }
+    }
+}  // namespace fl::algo
@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace fl::algo {
+    ThreadPool::ThreadPool(size_t threads_count) {
+        for (size_t i = 1; i < threads_count; ++i) {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_is_stopped = true;
+        }
+
+        m_task_cv.notify_all();
+
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::submit(Task task) {
+        if (m_workers.empty()) {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push(std::move(task));
+        }
+
+        m_task_cv.notify_one();
+    }
+
+    void ThreadPool::wait() {
+        std::unique_lock lock(m_mutex);
+
+        // The calling thread helps to drain the queue instead of sleeping
+        while (!m_tasks.empty()) {
+            Task task = std::move(m_tasks.front());
+            m_tasks.pop();
+            ++m_active_count;
+            lock.unlock();
+
+            task();
+
+            lock.lock();
+            --m_active_count;
+        }
+
+        m_done_cv.wait(lock, [this] {
+            return m_tasks.empty() && m_active_count == 0;
+        });
+    }
+
+    void ThreadPool::parallelFor(size_t count, size_t min_chunk, const RangeTask& task) {
+        min_chunk = std::max<size_t>(min_chunk, 1);
+        const size_t chunks_count = std::min((count + min_chunk - 1) / min_chunk, size());
+
+        if (chunks_count <= 1) {
+            task(0, count);
+            return;
+        }
+
+        const size_t chunk = (count + chunks_count - 1) / chunks_count;
+
+        for (size_t begin = 0; begin < count; begin += chunk) {
+            submit([&task, begin, end = std::min(begin + chunk, count)] {
+                task(begin, end);
+            });
+        }
+
+        wait();
+    }
+
+    void ThreadPool::workerLoop() {
+        std::unique_lock lock(m_mutex);
+
+        while (true) {
+            m_task_cv.wait(lock, [this] {
+                return m_is_stopped || !m_tasks.empty();
+            });
+
+            if (m_tasks.empty()) {
+                return;
+            }
+
+            Task task = std::move(m_tasks.front());
+            m_tasks.pop();
+            ++m_active_count;
+            lock.unlock();
+
+            task();
+
+            lock.lock();
+            --m_active_count;
+
+            if (m_tasks.empty() && m_active_count == 0) {
+                m_done_cv.notify_all();
+            }
+        }
+    }
+}  // namespace fl::algo
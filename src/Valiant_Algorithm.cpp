@@ -0,0 +1,270 @@
+#include "Valiant_Algorithm.h"
+
+#include "BitMatrix.h"
+#include "Lexer.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace {
+    using namespace fl;
+    using namespace fl::algo;
+
+    /**
+     * The chart is stored as one TriangularBitMatrix per nonterminal: matrices[A].test(i, j) == true,
+     * if A generates symbols[i:j]. Only the upper triangle of the 64 x 64 tiles over
+     * the positions is allocated, and the recursion goes over whole tiles, so its halves
+     * don't need a power of two.
+     *
+     * A product T[X][Y] * T[Y][Z] is accumulated straight into the matrices of the heads:
+     * it only writes the cells of X * Z, which are not final yet and are never read
+     * before complete() reaches them, so no separate set of partial products is needed.
+     *
+     * The tiles on the diagonal and the rectangles of single tiles are filled cell by cell.
+     * To check a split of the cell (i, j) with a couple of word operations, the column j
+     * of the right children is read as a packed row of a transposed tile: the final tile
+     * below the filled one is transposed before the filling, and the filled one is mirrored
+     * cell by cell as its cells become final.
+     */
+    class ValiantRecognizer {
+    public:
+        ValiantRecognizer(size_t symbols_count, const CompiledGrammar& cg, MultiplyAddKernel multiply_add);
+
+        void addTerminal(size_t pos, size_t len, size_t nt_code);
+        bool run();
+
+    private:
+        void compute(BitRange tiles);
+        void complete(BitRange rows, BitRange cols);
+
+        void multiplyRules(BitRange rows, BitRange mids, BitRange cols);
+
+        void fillTriangle(size_t T);
+        void fillRectangle(size_t I, size_t J);
+        void fillCell(size_t I, size_t J, size_t r, size_t c, BitWord near_mids, BitWord far_mids);
+
+    private:
+        size_t m_symbols_count;
+        const CompiledGrammar& m_cg;
+        MultiplyAddKernel m_multiply_add;
+        std::vector<TriangularBitMatrix> m_matrices;
+        TriangularBitMatrix m_product;
+
+        // The transposed tiles (I, J) and (J, J) of every nonterminal while the tile (I, J) is filled
+        std::vector<BitTile> m_near_columns;
+        std::vector<BitTile> m_far_columns;
+    };
+
+    // The bits [begin, end) of a word
+    BitWord getBitsBetween(size_t begin, size_t end) noexcept {
+        if (begin >= end) {
+            return 0;
+        }
+
+        return (~BitWord{0} >> (kBitWordBits - (end - begin))) << begin;
+    }
+
+    ValiantRecognizer::ValiantRecognizer(size_t symbols_count,
+                                         const CompiledGrammar& cg,
+                                         MultiplyAddKernel multiply_add)
+        : m_symbols_count(symbols_count)
+        , m_cg(cg)
+        , m_multiply_add(multiply_add) {
+        // The positions are 0..symbols_count
+        const size_t tiles_count = symbols_count / kBitTileSize + 1;
+
+        m_matrices.assign(cg.nt_count, TriangularBitMatrix(tiles_count));
+        m_product = TriangularBitMatrix(tiles_count);
+        m_near_columns.resize(cg.nt_count);
+        m_far_columns.resize(cg.nt_count);
+    }
+
+    void ValiantRecognizer::addTerminal(size_t pos, size_t len, size_t nt_code) {
+        m_matrices[nt_code].set(pos, pos + len);
+    }
+
+    bool ValiantRecognizer::run() {
+        compute({0, m_product.tilesCount()});
+
+        return m_matrices[m_cg.start_code].test(0, m_symbols_count);
+    }
+
+    // Fills all the cells (i, j) with i <= j, which are both in the tiles
+    void ValiantRecognizer::compute(BitRange tiles) {
+        if (tiles.size() == 1) {
+            fillTriangle(tiles.begin);
+            return;
+        }
+
+        const size_t mid = (tiles.begin + tiles.end) / 2;
+
+        compute({tiles.begin, mid});
+        compute({mid, tiles.end});
+        complete({tiles.begin, mid}, {mid, tiles.end});
+    }
+
+    /**
+     * Fills all the cells (i, j) with i in the rows tiles and j in the cols tiles. It's required that
+     * the cells inside rows and inside cols are final, and that the cells of
+     * rows * cols already hold all the products through the positions between rows and cols.
+     *
+     * The halves may differ in size, so a range of one tile is not split,
+     * while the other one still is
+     */
+    void ValiantRecognizer::complete(BitRange rows, BitRange cols) {
+        if (rows.size() == 1 && cols.size() == 1) {
+            fillRectangle(rows.begin, cols.begin);
+            return;
+        }
+
+        const size_t rows_mid = rows.size() == 1 ? rows.begin : (rows.begin + rows.end) / 2;
+        const size_t cols_mid = cols.size() == 1 ? cols.end : (cols.begin + cols.end) / 2;
+        const BitRange b{rows.begin, rows_mid};
+        const BitRange c{rows_mid, rows.end};
+        const BitRange d{cols.begin, cols_mid};
+        const BitRange e{cols_mid, cols.end};
+
+        complete(c, d);
+
+        if (b.size() != 0) {
+            multiplyRules(b, c, d);
+            complete(b, d);
+        }
+
+        if (e.size() != 0) {
+            multiplyRules(c, d, e);
+            complete(c, e);
+        }
+
+        if (b.size() != 0 && e.size() != 0) {
+            multiplyRules(b, c, e);
+            multiplyRules(b, d, e);
+            complete(b, e);
+        }
+    }
+
+    // T[rows][cols] |= {A | A -> BC, B in T[rows][mids], C in T[mids][cols]}
+    void ValiantRecognizer::multiplyRules(BitRange rows, BitRange mids, BitRange cols) {
+        for (const auto& pair : m_cg.pairs) {
+            const size_t heads_count = pair.heads_end - pair.heads_begin;
+            const auto& left = m_matrices[pair.left];
+            const auto& right = m_matrices[pair.right];
+
+            if (heads_count == 1) {
+                m_multiply_add(m_matrices[m_cg.heads[pair.heads_begin]], left, right, rows, mids, cols);
+                continue;
+            }
+
+            clearRegion(m_product, rows, cols);
+            m_multiply_add(m_product, left, right, rows, mids, cols);
+
+            for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                orRegion(m_matrices[m_cg.heads[h]], m_product, rows, cols);
+            }
+        }
+    }
+
+    void ValiantRecognizer::fillTriangle(size_t T) {
+        std::fill(m_near_columns.begin(), m_near_columns.end(), BitTile{});
+
+        for (size_t r = kBitTileSize; r-- > 0;) {
+            for (size_t c = r + 1; c < kBitTileSize; ++c) {
+                fillCell(T, T, r, c, getBitsBetween(r + 1, c), 0);
+            }
+        }
+    }
+
+    void ValiantRecognizer::fillRectangle(size_t I, size_t J) {
+        std::fill(m_near_columns.begin(), m_near_columns.end(), BitTile{});
+
+        for (size_t a = 0; a < m_cg.nt_count; ++a) {
+            transposeTile(m_far_columns[a], m_matrices[a].tile(J, J));
+        }
+
+        for (size_t r = kBitTileSize; r-- > 0;) {
+            for (size_t c = 0; c < kBitTileSize; ++c) {
+                fillCell(I, J, r, c, getBitsBetween(r + 1, kBitTileSize), getBitsBetween(0, c));
+            }
+        }
+    }
+
+    /**
+     * Finishes the cell (r, c) of the tile (I, J) with the splits through the positions near_mids
+     * of the tile I and far_mids of the tile J, all the other splits must be already accounted
+     */
+    void ValiantRecognizer::fillCell(size_t I, size_t J, size_t r, size_t c, BitWord near_mids, BitWord far_mids) {
+        for (size_t b = 0; b < m_cg.nt_count; ++b) {
+            const BitWord near_left = m_matrices[b].tile(I, I).rows[r] & near_mids;
+            const BitWord far_left = m_matrices[b].tile(I, J).rows[r] & far_mids;
+
+            if (near_left == 0 && far_left == 0) {
+                continue;
+            }
+
+            for (size_t p = m_cg.left_offsets[b]; p < m_cg.left_offsets[b + 1]; ++p) {
+                const auto& pair = m_cg.pairs[p];
+
+                if ((near_left & m_near_columns[pair.right].rows[c]) == 0 &&
+                    (far_left & m_far_columns[pair.right].rows[c]) == 0) {
+                    continue;
+                }
+
+                for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                    m_matrices[m_cg.heads[h]].tile(I, J).rows[r] |= BitWord{1} << c;
+                }
+            }
+        }
+
+        for (size_t a = 0; a < m_cg.nt_count; ++a) {
+            m_near_columns[a].rows[c] |= ((m_matrices[a].tile(I, J).rows[r] >> c) & 1u) << r;
+        }
+    }
+}  // namespace
+
+namespace fl::algo::valiant {
+    bool isRecognized(std::string_view text, const CompiledGrammar& cg, const RecognitionOptions& options) {
+        using ProductKernel = RecognitionOptions::ProductKernel;
+
+        if (cg.empty()) {
+            return false;
+        }
+
+        if (text.empty()) {
+            return cg.generates_empty;
+        }
+
+        // The products are computed in one thread, so options.threads_count is not used
+        MultiplyAddKernel multiply_add = multiplyAdd;
+
+        switch (options.kernel) {
+            case ProductKernel::kNaive:
+                multiply_add = multiplyAdd;
+                break;
+            case ProductKernel::kFourRussians:
+                multiply_add = multiplyAddFourRussians;
+                break;
+        }
+
+        // The symbols are the characters of the text or its tokens
+        std::vector<std::tuple<size_t, size_t, size_t>> matches;
+        const auto symbols_count = findSymbolMatches(text, cg, options, [&](size_t pos, size_t len, size_t nt_code) {
+            matches.emplace_back(pos, len, nt_code);
+        });
+
+        if (!symbols_count) {
+            return false;
+        }
+
+        if (*symbols_count == 0) {
+            return cg.generates_empty;
+        }
+
+        ValiantRecognizer recognizer(*symbols_count, cg, multiply_add);
+
+        for (const auto& [pos, len, nt_code] : matches) {
+            recognizer.addTerminal(pos, len, nt_code);
+        }
+
+        return recognizer.run();
+    }
+}  // namespace fl::algo::valiant
@@ -0,0 +1,35 @@
+#include "Application.h"
+
+#include <iostream>
+#include <optional>
+
+#include "BatchRecognition.h"
+#include "ThreadPool.h"
+
+
+namespace logic {
+    void Application::execBatchRecognition(const ui::ParsedArguments& pargs) {
+        if (!pargs.batch_path) {
+            m_exceptor.sendException("a batch path is not provided.\n");
+        }
+
+        // The batch is opened before the grammar is prepared, so a wrong path fails fast
+        std::optional<BatchReader> reader;
+
+        try {
+            reader.emplace(*pargs.batch_path, pargs.is_batch_corpus);
+        }
+        catch (std::exception& e) {
+            m_exceptor.sendException(e.what());
+        }
+
+        PreparedGrammar prepared;
+        prepareGrammar(pargs, prepared);
+
+        fl::algo::ThreadPool pool(pargs.threads_count);
+
+        recognizeBatch(*reader, pool, std::cout, [&](std::string_view text) {
+            return recognizeText(text, prepared, pargs, 1);
+        });
+    }
+}  // namespace logic
@@ -8,8 +8,25 @@
 
 #include "Grammar.h"
 #include "GrammarAlgorithms.h"
+#include "CompiledGrammarFile.h"
 
 namespace logic {
+    fl::algo::ConversionOptions Application::getConversionOptions(const ui::ParsedArguments& pargs) {
+        fl::algo::ConversionOptions options;
+        // The recognition always needs the whole conversion
+        if (pargs.mode == ui::ParsedArguments::ProgramMode::kConversion) {
+            options.end_phase = pargs.conversion_end_phase.value_or(0);
+        }
+
+        options.dump_directory = pargs.dump_directory;
+
+        if (pargs.stats_filename) {
+            options.statistics = &m_statistics.conversion.emplace();
+        }
+
+        return options;
+    }
+
     void Application::execConversion(const ui::ParsedArguments& pargs) {
         fl::Grammar g;
 
@@ -32,13 +49,23 @@ namespace logic {
             }
 
 
-            fl::algo::convertToChomskyForm(g, *pargs.conversion_end_phase);
+            fl::algo::convertToChomskyForm(g, getConversionOptions(pargs));
 
             if (fout.is_open()) {
                 fout << g;
             } else {
                 std::cout << g;
             }
+
+            if (pargs.compiled_grammar_filename) {
+                if (!fl::algo::isInChomskyForm(g)) {
+                    throw std::invalid_argument("only a grammar in the Chomsky form can be compiled.\n");
+                }
+
+                fl::algo::CompiledGrammar cg;
+                fl::algo::initCompiledGrammar(cg, g);
+                saveCompiledGrammar(pargs, cg);
+            }
         }
         catch (std::exception& e) {
             m_exceptor.sendException(e.what());
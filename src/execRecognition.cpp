@@ -5,41 +5,84 @@
 
 #include "Grammar.h"
 #include "GrammarAlgorithms.h"
+#include "Valiant_Algorithm.h"
+#include "CYK_Incremental.h"
+#include "CYK_Semiring.h"
+#include "CYK_Forest.h"
+#include "CompiledGrammarFile.h"
+#include "MappedFile.h"
 
 
-namespace {
-    void readText(std::ifstream& fin, std::string& text) {
-        fin.seekg(0, std::ios::end);
-        auto text_size = fin.tellg();
-        text.resize(text_size);
-        fin.seekg(0, std::ios::beg);
-        fin.read(&text[0], text_size);
+namespace logic {
+    void Application::prepareGrammar(const ui::ParsedArguments& pargs, PreparedGrammar& prepared) {
+        if (pargs.engine == ui::ParsedArguments::RecognitionEngine::kEarley) {
+            loadEarleyGrammar(pargs, prepared.eg);
+        } else {
+            loadCompiledGrammar(pargs, prepared);
+        }
     }
-}  // namespace
 
-namespace logic {
-    void Application::execRecognition(const ui::ParsedArguments& pargs) {
-        fl::Grammar g;
-        std::string text;
+    void Application::loadEarleyGrammar(const ui::ParsedArguments& pargs, fl::algo::earley::EarleyGrammar& eg) {
+        if (pargs.converted_grammar_filename || pargs.compiled_grammar_filename) {
+            m_exceptor.sendException("the \"earley\" engine does not convert the grammar, there is nothing to save.\n");
+        }
 
-        if (!pargs.text_filename) {
-            m_exceptor.sendException("a text file is not provided.\n");
+        if (pargs.is_token_level || pargs.is_prediction_filtered || pargs.need_viable_prefix || pargs.semiring ||
+            pargs.forest_filename || pargs.need_parse_tree || pargs.stats_filename || pargs.dump_directory) {
+            m_exceptor.sendException("the \"earley\" engine supports none of the '-t', '-f', '-p', '-w', '-F', '-T', '-S' and '-d' flags.\n");
         }
 
+        fl::Grammar g;
         std::ifstream grammar_fin(pargs.grammar_filename);
-        std::ifstream text_fin(*pargs.text_filename);
-        std::ofstream fout;
 
-        if (!text_fin.good()) {
-            m_exceptor.sendException("failed to open the text file.\n");
+        if (!grammar_fin.good()) {
+            m_exceptor.sendException("failed to open the grammar file.\n");
         }
 
+        try {
+            grammar_fin >> g;
+        }
+        catch (std::exception& e) {
+            m_exceptor.sendException(e.what());
+        }
+
+        fl::algo::earley::initEarleyGrammar(eg, g);
+    }
+
+    void Application::loadCompiledGrammar(const ui::ParsedArguments& pargs, PreparedGrammar& prepared) {
+        auto& cg = prepared.cg;
+
+        try {
+            fl::MappedFile grammar_file(pargs.grammar_filename);
+
+            if (fl::algo::isCompiledGrammarFile(grammar_file.view())) {
+                if (pargs.converted_grammar_filename) {
+                    m_exceptor.sendException("the grammar is already compiled, there is no converted grammar to save.\n");
+                }
+
+                fl::algo::initCompiledGrammar(cg, grammar_file);
+                saveCompiledGrammar(pargs, cg);
+                return;
+            }
+        }
+        catch (std::exception& e) {
+            m_exceptor.sendException(e.what());
+        }
+
+        fl::Grammar g;
+        std::ifstream grammar_fin(pargs.grammar_filename);
+        std::ofstream fout;
+
         if (!grammar_fin.good()) {
             m_exceptor.sendException("failed to open the grammar file.\n");
         }
 
         grammar_fin >> g;
-        readText(text_fin, text);
+
+        // The conversion merges derivations, so they are counted over the grammar as it is written
+        if (pargs.semiring == ui::ParsedArguments::WeightSemiring::kCount) {
+            fl::algo::earley::initEarleyGrammar(prepared.eg, g);
+        }
 
         if (pargs.converted_grammar_filename) {
             fout.open(pargs.converted_grammar_filename.value());
@@ -54,21 +97,215 @@ namespace logic {
                 m_exceptor.sendException("the grammar is said to be in Chomsky form, but it is not.\n");
             }
         } else {
-            fl::algo::convertToChomskyForm(g, *pargs.conversion_end_phase);
+            // The weights are not carried through the new rules of the conversion
+            if (pargs.semiring == ui::ParsedArguments::WeightSemiring::kBest) {
+                m_exceptor.sendException("the \"best\" semiring requires a grammar already in Chomsky form.\n");
+            }
+
+            try {
+                fl::algo::convertToChomskyForm(g, getConversionOptions(pargs));
+            }
+            catch (std::exception& e) {
+                m_exceptor.sendException(e.what());
+            }
+
+            if (!fl::algo::isInChomskyForm(g)) {
+                m_exceptor.sendException("the converted grammar is not in the Chomsky form, it can't be recognized with.\n");
+            }
         }
 
         if (fout.is_open()) {
             fout << g;
-        } else {
+        } else if (pargs.mode == ui::ParsedArguments::ProgramMode::kRecognition) {
+            // The batch output is one line per input, so the grammar is only saved there
             m_talker->sendMessage("The converted grammar:\n" + g.toString());
         }
 
-        bool recognition_res = fl::algo::cyk::isRecognized(text, g);
+        fl::algo::initCompiledGrammar(cg, g);
+        saveCompiledGrammar(pargs, cg);
+    }
+
+    void Application::saveCompiledGrammar(const ui::ParsedArguments& pargs, const fl::algo::CompiledGrammar& cg) {
+        if (!pargs.compiled_grammar_filename) {
+            return;
+        }
+
+        std::ofstream fout(*pargs.compiled_grammar_filename, std::ios::binary);
+
+        if (!fout.good()) {
+            m_exceptor.sendException("failed to open the file for a compiled grammar.\n");
+        }
+
+        fl::algo::saveCompiledGrammar(fout, cg);
+    }
+
+    bool Application::recognizeText(std::string_view text,
+                                    const PreparedGrammar& prepared,
+                                    const ui::ParsedArguments& pargs,
+                                    size_t threads_count,
+                                    fl::algo::RecognitionStatistics* statistics) {
+        const auto& cg = prepared.cg;
+
+        fl::algo::RecognitionOptions options;
+        options.threads_count = threads_count;
+        options.statistics = statistics;
+        options.is_token_level = pargs.is_token_level;
+        options.is_prediction_filtered = pargs.is_prediction_filtered;
+        options.kernel = pargs.kernel == ui::ParsedArguments::ProductKernel::kFourRussians
+                         ? fl::algo::RecognitionOptions::ProductKernel::kFourRussians
+                         : fl::algo::RecognitionOptions::ProductKernel::kNaive;
+
+        switch (pargs.engine) {
+            case ui::ParsedArguments::RecognitionEngine::kCYK:
+                return fl::algo::cyk::isRecognized(text, cg, options);
+            case ui::ParsedArguments::RecognitionEngine::kValiant:
+                return fl::algo::valiant::isRecognized(text, cg, options);
+            case ui::ParsedArguments::RecognitionEngine::kEarley:
+                return fl::algo::earley::isRecognized(text, prepared.eg);
+        }
+
+        return false;
+    }
+
+    void Application::execRecognition(const ui::ParsedArguments& pargs) {
+        if (!pargs.text_filename) {
+            m_exceptor.sendException("a text file is not provided.\n");
+        }
+
+        // The text is parsed right in the mapped file, it is never copied
+        std::optional<fl::TextInput> text_input;
+
+        try {
+            text_input.emplace(*pargs.text_filename);
+        }
+        catch (std::exception&) {
+            m_exceptor.sendException("failed to open the text file.\n");
+        }
+
+        const std::string_view text = text_input->view();
+
+        PreparedGrammar prepared;
+        prepareGrammar(pargs, prepared);
+
+        // Only the "cyk" engine reports the cost of the recognition
+        fl::algo::RecognitionStatistics* statistics = nullptr;
+
+        if (pargs.stats_filename && pargs.engine == ui::ParsedArguments::RecognitionEngine::kCYK) {
+            statistics = &m_statistics.recognition.emplace();
+        }
+
+        bool recognition_res = recognizeText(text, prepared, pargs, pargs.threads_count, statistics);
 
         std::cout << std::string(recognition_res ? "Yes" : "No") +
                      ", the text is" +
                      std::string(recognition_res ? " " : " not ") +
                      "recognized by the grammar." << std::endl;
+
+        if (pargs.need_viable_prefix) {
+            // The prefix is found over the characters, its length would not match a verdict over the tokens
+            if (pargs.is_token_level) {
+                m_exceptor.sendException("the viable prefix is found only with the characters as symbols.\n");
+            }
+
+            size_t viable_size = fl::algo::cyk::findLongestViablePrefix(text, prepared.cg);
+
+            std::cout << "The longest viable prefix has length " << viable_size;
+
+            if (viable_size < text.size()) {
+                std::cout << ", the first offending position is " << viable_size;
+            }
+
+            std::cout << "." << std::endl;
+        }
+
+        if (pargs.semiring) {
+            printSemiringValue(text, prepared, pargs);
+        }
+
+        if (pargs.forest_filename || pargs.need_parse_tree) {
+            outputParseForest(text, prepared.cg, pargs);
+        }
     }
-}  // namespace logic
 
+    void Application::outputParseForest(std::string_view text,
+                                        const fl::algo::CompiledGrammar& cg,
+                                        const ui::ParsedArguments& pargs) {
+        if (pargs.is_token_level) {
+            m_exceptor.sendException("the parse forest is built only with the characters as symbols.\n");
+        }
+
+        fl::algo::cyk::ParseForest forest;
+        fl::algo::cyk::buildParseForest(forest, text, cg);
+
+        if (pargs.forest_filename) {
+            std::ofstream fout(*pargs.forest_filename);
+
+            if (!fout.good()) {
+                m_exceptor.sendException("failed to open the file for a parse forest.\n");
+            }
+
+            fl::algo::cyk::printParseForest(fout, forest, text, cg);
+        }
+
+        if (pargs.need_parse_tree) {
+            if (forest.empty()) {
+                std::cout << "There is no parse tree." << std::endl;
+            } else {
+                std::cout << "A parse tree:" << std::endl;
+                fl::algo::cyk::printParseTree(std::cout, forest, text, cg);
+            }
+        }
+    }
+
+    void Application::printSemiringValue(std::string_view text,
+                                         const PreparedGrammar& prepared,
+                                         const ui::ParsedArguments& pargs) {
+        const auto& cg = prepared.cg;
+
+        fl::algo::RecognitionOptions options;
+        options.is_token_level = pargs.is_token_level;
+
+        try {
+            switch (*pargs.semiring) {
+                case ui::ParsedArguments::WeightSemiring::kCount: {
+                    using fl::algo::CountingSemiring;
+
+                    if (pargs.is_token_level) {
+                        throw std::invalid_argument("the weighted recognition works only with the characters as symbols.\n");
+                    }
+
+                    // Only a compiled grammar file has no grammar as written, its own rules are counted then
+                    const auto count = prepared.eg.empty()
+                                       ? fl::algo::cyk::evaluate<CountingSemiring>(text, cg, options)
+                                       : fl::algo::earley::countDerivations(text, prepared.eg);
+
+                    std::cout << "The number of derivations is ";
+
+                    if (count == CountingSemiring::kSaturated) {
+                        std::cout << "at least " << count;
+                    } else {
+                        std::cout << count;
+                    }
+
+                    std::cout << "." << std::endl;
+                    break;
+                }
+                case ui::ParsedArguments::WeightSemiring::kBest: {
+                    using fl::algo::TropicalSemiring;
+                    const double weight = fl::algo::cyk::evaluate<TropicalSemiring>(text, cg, options);
+
+                    if (weight == TropicalSemiring::zero()) {
+                        std::cout << "There is no derivation to weigh." << std::endl;
+                    } else {
+                        std::cout << "The best derivation has weight " << weight << "." << std::endl;
+                    }
+
+                    break;
+                }
+            }
+        }
+        catch (std::exception& e) {
+            m_exceptor.sendException(e.what());
+        }
+    }
+}  // namespace logic
@@ -0,0 +1,26 @@
+#include "Application.h"
+
+#include <iostream>
+
+#include "StreamRecognition.h"
+#include "ThreadPool.h"
+
+
+namespace logic {
+    void Application::execStreamRecognition(const ui::ParsedArguments& pargs) {
+        // The unsynchronised streams have their own buffers,
+        // so the reader can tell a full block from an idle input.
+        // std::cin is read in another thread, so it must not flush std::cout
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+
+        PreparedGrammar prepared;
+        prepareGrammar(pargs, prepared);
+
+        fl::algo::ThreadPool pool(pargs.threads_count);
+
+        recognizeStream(std::cin, std::cout, pargs.is_nul_separated ? '\0' : '\n', pool, [&](std::string_view text) {
+            return recognizeText(text, prepared, pargs, 1);
+        });
+    }
+}  // namespace logic
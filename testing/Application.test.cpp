@@ -0,0 +1,280 @@
+#include "ArgumentParsing.h"
+#include "BatchRecognition.h"
+#include "ExceptionController.h"
+#include "StreamRecognition.h"
+#include "Talker.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+
+namespace {
+    ui::ParsedArguments parseArguments(std::vector<std::string> args) {
+        logic::ExceptionController exceptor;
+        exceptor.setTalker(std::make_shared<ui::Talker>(exceptor));
+
+        args.insert(args.begin(), "gc-cykp");
+        std::vector<char*> argv;
+
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+
+        return ui::parseArguments(exceptor, static_cast<int>(argv.size()), argv.data());
+    }
+
+    std::string recognizeStream(const std::string& input, char delimiter, size_t threads_count) {
+        std::istringstream in(input);
+        std::ostringstream out;
+        fl::algo::ThreadPool pool(threads_count);
+
+        // A record is recognized if it is a number divisible by 3
+        logic::recognizeStream(in, out, delimiter, pool, [](std::string_view text) {
+            return std::stoul(std::string(text)) % 3 == 0;
+        });
+
+        return out.str();
+    }
+
+    std::string recognizeBatch(const std::filesystem::path& batch_path, bool is_corpus, size_t threads_count) {
+        logic::BatchReader reader(batch_path, is_corpus);
+        std::ostringstream out;
+        fl::algo::ThreadPool pool(threads_count);
+
+        // A text is recognized if its length is even
+        logic::recognizeBatch(reader, pool, out, [](std::string_view text) {
+            return text.size() % 2 == 0;
+        });
+
+        return out.str();
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream fout(path, std::ios::binary);
+        ASSERT_TRUE(fout.good());
+        fout << content;
+    }
+}
+
+
+TEST(ApplicationSuite, PerTextFlagsTest) {
+    using ProgramMode = ui::ParsedArguments::ProgramMode;
+
+    const auto pargs = parseArguments({"-R", "text.txt", "-p", "-T", "-w", "count", "grammar.txt"});
+
+    ASSERT_EQ(pargs.mode, ProgramMode::kRecognition);
+    ASSERT_TRUE(pargs.need_viable_prefix);
+    ASSERT_TRUE(pargs.need_parse_tree);
+
+    ASSERT_EQ(parseArguments({"-I", "-0", "-f", "-j", "4", "grammar.txt"}).mode, ProgramMode::kStreamRecognition);
+    ASSERT_EQ(parseArguments({"-B", "list.txt", "-c", "grammar.txt"}).mode, ProgramMode::kBatchRecognition);
+
+    // A batch and a stream only print the verdicts, so the flags asking for more are rejected
+    for (const char* mode : {"-I", "-B"}) {
+        std::vector<std::string> args = {mode};
+
+        if (args.front() == "-B") {
+            args.emplace_back("list.txt");
+        }
+
+        for (const std::vector<std::string>& flags : std::vector<std::vector<std::string>>{
+                {"-p"}, {"-T"}, {"-w", "count"}, {"-F", "forest.txt"}}) {
+            auto flagged_args = args;
+            flagged_args.insert(flagged_args.end(), flags.begin(), flags.end());
+            flagged_args.emplace_back("grammar.txt");
+
+            ASSERT_DEATH(parseArguments(flagged_args), "") << mode << ' ' << flags.front();
+
+            // The order of the flags doesn't matter
+            std::rotate(flagged_args.begin(), flagged_args.begin() + static_cast<long>(args.size()), flagged_args.end() - 1);
+
+            ASSERT_DEATH(parseArguments(flagged_args), "") << flags.front() << ' ' << mode;
+        }
+    }
+}
+
+TEST(ApplicationSuite, StreamSplittingTest) {
+    ASSERT_EQ(recognizeStream("", '\n', 1), "");
+    ASSERT_EQ(recognizeStream("3\n4\n", '\n', 1), "Yes\nNo\n");
+
+    // The last record may be not ended
+    ASSERT_EQ(recognizeStream("3\n4\n6", '\n', 1), "Yes\nNo\nYes\n");
+
+    // An empty record is a record too
+    std::istringstream in("ab\n\ncd\n");
+    std::ostringstream out;
+    fl::algo::ThreadPool pool(1);
+    std::vector<std::string> records;
+
+    logic::recognizeStream(in, out, '\n', pool, [&](std::string_view text) {
+        records.emplace_back(text);
+        return text.empty();
+    });
+
+    ASSERT_EQ(records, (std::vector<std::string>{"ab", "", "cd"}));
+    ASSERT_EQ(out.str(), "No\nYes\nNo\n");
+
+    // With the NUL separation a newline is a part of a record
+    const std::string nul_input("a\nb\0\0c\0", 7);
+    std::istringstream nul_in(nul_input);
+    std::ostringstream nul_out;
+    records.clear();
+
+    logic::recognizeStream(nul_in, nul_out, '\0', pool, [&](std::string_view text) {
+        records.emplace_back(text);
+        return text.size() == 3;
+    });
+
+    ASSERT_EQ(records, (std::vector<std::string>{"a\nb", "", "c"}));
+    ASSERT_EQ(nul_out.str(), "Yes\nNo\nNo\n");
+}
+
+TEST(ApplicationSuite, StreamOrderTest) {
+    // Several blocks more than the queue holds, recognized by several threads
+    const size_t records_count = (logic::kStreamQueuedBlocks + 3) * logic::kStreamBlockSize + 7;
+
+    std::string input;
+    std::string expected;
+
+    for (size_t i = 0; i < records_count; ++i) {
+        input += std::to_string(i) + '\n';
+        expected += i % 3 == 0 ? "Yes\n" : "No\n";
+    }
+
+    ASSERT_EQ(recognizeStream(input, '\n', 1), expected);
+    ASSERT_EQ(recognizeStream(input, '\n', 4), expected);
+}
+
+TEST(ApplicationSuite, StreamBlockQueueTest) {
+    using logic::kStreamQueuedBlocks;
+
+    logic::StreamBlockQueue queue;
+    const size_t blocks_count = 10 * kStreamQueuedBlocks;
+
+    // The producer waits for the consumer whenever the queue is full
+    std::thread producer([&] {
+        for (size_t i = 0; i < blocks_count; ++i) {
+            logic::StreamBlock block;
+            block.records.push_back(std::to_string(i));
+            block.is_last = i + 1 == blocks_count;
+
+            ASSERT_TRUE(queue.push(std::move(block)));
+        }
+    });
+
+    for (size_t i = 0; i < blocks_count; ++i) {
+        const logic::StreamBlock block = queue.pop();
+
+        ASSERT_EQ(block.records, std::vector<std::string>{std::to_string(i)});
+        ASSERT_EQ(block.is_last, i + 1 == blocks_count);
+    }
+
+    producer.join();
+
+    // A producer waiting on a full queue is released by close()
+    for (size_t i = 0; i < kStreamQueuedBlocks; ++i) {
+        ASSERT_TRUE(queue.push({}));
+    }
+
+    std::thread blocked_producer([&] {
+        ASSERT_FALSE(queue.push({}));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.close();
+    blocked_producer.join();
+
+    ASSERT_FALSE(queue.push({}));
+}
+
+TEST(ApplicationSuite, StreamErrorTest) {
+    // The reader is still reading (or waiting on the full queue) when the recognition throws
+    std::string input;
+
+    for (size_t i = 0; i < (logic::kStreamQueuedBlocks + 3) * logic::kStreamBlockSize; ++i) {
+        input += std::to_string(i) + '\n';
+    }
+
+    std::istringstream in(input);
+    std::ostringstream out;
+    fl::algo::ThreadPool pool(1);
+
+    ASSERT_THROW(logic::recognizeStream(in, out, '\n', pool, [](std::string_view text) -> bool {
+        if (text == "10") {
+            throw std::runtime_error("failed to recognize");
+        }
+
+        return true;
+    }), std::runtime_error);
+
+    ASSERT_TRUE(out.str().empty());
+}
+
+TEST(ApplicationSuite, BatchDirectoryTest) {
+    namespace fs = std::filesystem;
+
+    const fs::path directory = "batch_directory";
+    fs::remove_all(directory);
+    fs::create_directories(directory / "nested");
+
+    writeFile(directory / "b.txt", "abc");
+    writeFile(directory / "a.txt", "ab");
+    writeFile(directory / "c.txt", "");
+    writeFile(directory / "nested" / "d.txt", "abcd");
+
+    // Only the regular files of the directory itself, in the sorted order
+    const std::string a_path = (directory / "a.txt").string();
+    const std::string b_path = (directory / "b.txt").string();
+    const std::string c_path = (directory / "c.txt").string();
+
+    ASSERT_EQ(recognizeBatch(directory, false, 2), a_path + "\tYes\n" + b_path + "\tNo\n" + c_path + "\tYes\n");
+
+    // A list is read relative to its own directory, wherever the program is run from
+    writeFile(directory / "nested" / "list.txt",
+              "d.txt\n\n../b.txt\nmissing.txt\n" + fs::absolute(directory / "a.txt").string() + "\n");
+
+    ASSERT_EQ(recognizeBatch(directory / "nested" / "list.txt", false, 1),
+              "d.txt\tYes\n../b.txt\tNo\nmissing.txt\tFailed to read\n" +
+              fs::absolute(directory / "a.txt").string() + "\tYes\n");
+
+    fs::remove_all(directory);
+
+    ASSERT_THROW(logic::BatchReader(directory / "list.txt", false), std::runtime_error);
+}
+
+TEST(ApplicationSuite, BatchCorpusTest) {
+    const char* const path = "batch_corpus.txt";
+
+    // Every line is a text, an empty one too, the lines are named by their numbers
+    writeFile(path, "ab\nabc\n\nabcd");
+
+    ASSERT_EQ(recognizeBatch(path, true, 1), "1\tYes\n2\tNo\n3\tYes\n4\tYes\n");
+
+    // Several blocks recognized by several threads keep the order of the corpus
+    const size_t lines_count = 2 * logic::kBatchBlockSize + 5;
+    std::string corpus;
+    std::string expected;
+
+    for (size_t i = 0; i < lines_count; ++i) {
+        corpus += std::string(i % 5, 'a') + '\n';
+        expected += std::to_string(i + 1) + (i % 5 % 2 == 0 ? "\tYes\n" : "\tNo\n");
+    }
+
+    writeFile(path, corpus);
+
+    ASSERT_EQ(recognizeBatch(path, true, 4), expected);
+
+    std::remove(path);
+}
@@ -9,9 +9,10 @@
 #include <gtest/gtest.h>
 
 
-using details::TableValue;
-using details::Grammar;
-using details::rule_violation;
+using fl::Grammar;
+using fl::GrammarBuilder;
+using fl::GrammarInputException;
+using fl::TokenType;
 
 
 namespace {
@@ -20,7 +21,7 @@ namespace {
             in >> g;
             FAIL();
         }
-        catch (rule_violation& v) {
+        catch (GrammarInputException& v) {
             ASSERT_TRUE(std::strstr(v.what(), message_part) != nullptr);
         }
         catch (std::exception& e) {
@@ -47,27 +48,25 @@ TEST(GrammarIOSuite, MultipleRulesWithSimilarLeftSideTest) {
     ASSERT_TRUE(fin.good());
 
     Grammar g;
-    Grammar xptd_g;
-
-    std::vector<std::string> words = {"input", "", "abc", "line", "test", "magic", "why", "how"};
-    std::vector<TableValue::TokenType> words_type(words.size());
-    std::vector<size_t> words_i(words.size());
-
-    words_type[0] = words_type[3] = TableValue::k_Terminal;
-
-    for (size_t j = 0; j < words_i.size(); ++j) {
-        words_i[j] = xptd_g.tdtable.insert(std::move(words[j]), words_type[j]);
-    }
-
-    size_t input_i = words_i[0];
-    size_t line_i = words_i[3];
-
-    xptd_g.multirules[input_i].push_back({{words_i[1]}, {}});
-    xptd_g.multirules[input_i].push_back({{words_i[2]}, {}});
-    xptd_g.multirules[line_i].push_back({{words_i[4]}, {}});
-    xptd_g.multirules[line_i].push_back({{words_i[5]}, {}});
-    xptd_g.multirules[input_i].push_back({{words_i[6]}, {}});
-    xptd_g.multirules[input_i].push_back({{words_i[7]}, {}});
+    GrammarBuilder builder;
+
+    builder.addRule("input");
+    builder.addRuleRightSide();
+    builder.pushToken("", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("abc", TokenType::kTerminal);
+    builder.addRule("line");
+    builder.addRuleRightSide();
+    builder.pushToken("test", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("magic", TokenType::kTerminal);
+    builder.addRule("input");
+    builder.addRuleRightSide();
+    builder.pushToken("why", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("how", TokenType::kTerminal);
+
+    const Grammar xptd_g = std::move(builder).getGrammar();
 
     ASSERT_NO_THROW(fin >> g);
 
@@ -90,29 +89,23 @@ TEST(GrammarIOSuite, EscapedQuoteTest) {
     ASSERT_TRUE(fin.good());
 
     Grammar g;
-    Grammar xptd_g;
-
-    std::vector<std::string> words = {"input", "line", "", "\"", "abc"};
-    std::vector<TableValue::TokenType> words_type(words.size());
-    std::vector<size_t> words_i(words.size());
-
-    words_type[0] = words_type[1] = TableValue::k_Nonterminal;
-
-    for (size_t j = 0; j < words_i.size(); ++j) {
-        words_i[j] = xptd_g.tdtable.insert(std::move(words[j]), words_type[j]);
-    }
-
-    size_t input_i = words_i[0];
-    size_t line_i = words_i[1];
+    GrammarBuilder builder;
+
+    builder.addRule("input");
+    builder.addRuleRightSide();
+    builder.pushToken("", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("line", TokenType::kNonterminal);
+    builder.addRuleRightSide();
+    builder.pushToken("\"", TokenType::kTerminal);
+    builder.pushToken("line", TokenType::kNonterminal);
+    builder.pushToken("\"", TokenType::kTerminal);
+    builder.addRule("line");
+    builder.addRuleRightSide();
+    builder.pushToken("abc", TokenType::kTerminal);
+
+    const Grammar xptd_g = std::move(builder).getGrammar();
 
-    auto& input_rules = xptd_g.multirules[input_i];
-    auto& line_rules = xptd_g.multirules[line_i];
-
-    input_rules.insert(input_rules.begin(), {{{words_i[2]}, {}},
-                                             {{line_i}, {0}},
-                                             {{words_i[3], line_i, words_i[3]}, {1}}});
-    line_rules.insert(line_rules.begin(), {{{words_i[4]}, {}}});
-    
     ASSERT_NO_THROW(fin >> g);
     ASSERT_EQ(g, xptd_g);
 }
@@ -123,34 +116,22 @@ TEST(GrammarIOSuite, MultilineTerminalTest) {
     ASSERT_TRUE(fin.good());
 
     Grammar g;
-    Grammar xptd_g;
-
-    std::vector<std::string> words = {"input",
-                                      "line",
-                                      "",
-                                      "will you work correctly?",
-                                      "(",
-                                      ")"};
-    std::vector<TableValue::TokenType> words_type(words.size());
-    std::vector<size_t> words_i(words.size());
-
-    words_type[0] = words_type[1] = TableValue::k_Nonterminal;
-
-    for (size_t j = 0; j < words_i.size(); ++j) {
-        words_i[j] = xptd_g.tdtable.insert(std::move(words[j]), words_type[j]);
-    }
-
-    size_t input_i = words_i[0];
-    size_t line_i = words_i[1];
-
-    auto& input_rules = xptd_g.multirules[input_i];
-    auto& line_rules = xptd_g.multirules[line_i];
-
-    input_rules.insert(input_rules.begin(), {{{words_i[2]}, {}},
-                                            {{line_i}, {0}}});
-
-    line_rules.insert(line_rules.begin(), {{{words_i[3]}, {}},
-                                           {{words_i[4], line_i, words_i[5]}, {1}}});
+    GrammarBuilder builder;
+
+    builder.addRule("input");
+    builder.addRuleRightSide();
+    builder.pushToken("", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("line", TokenType::kNonterminal);
+    builder.addRule("line");
+    builder.addRuleRightSide();
+    builder.pushToken("will you work correctly?", TokenType::kTerminal);
+    builder.addRuleRightSide();
+    builder.pushToken("(", TokenType::kTerminal);
+    builder.pushToken("line", TokenType::kNonterminal);
+    builder.pushToken(")", TokenType::kTerminal);
+
+    const Grammar xptd_g = std::move(builder).getGrammar();
 
     ASSERT_NO_THROW(fin >> g);
     ASSERT_EQ(g, xptd_g);
@@ -0,0 +1,825 @@
+#include "GrammarAlgorithms.h"
+#include "CYK_Incremental.h"
+#include "CYK_Semiring.h"
+#include "CYK_Forest.h"
+#include "Valiant_Algorithm.h"
+#include "Earley_Algorithm.h"
+#include "CompiledGrammarFile.h"
+#include "BitKernels.h"
+#include "BitMatrix.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+
+using fl::Grammar;
+using fl::algo::CompiledGrammar;
+
+
+namespace {
+    void loadCompiledGrammar(const char* const path, CompiledGrammar& cg) {
+        std::ifstream fin(path);
+
+        ASSERT_TRUE(fin.good());
+
+        Grammar g;
+
+        ASSERT_NO_THROW(fin >> g);
+
+        fl::algo::convertToChomskyForm(g, 0);
+        fl::algo::initCompiledGrammar(cg, g);
+    }
+
+    std::string getNestedBrackets(size_t depth) {
+        return std::string(depth, '(') + std::string(depth, ')');
+    }
+}
+
+
+TEST(RecognitionSuite, TerminalMatcherTest) {
+    fl::algo::TerminalMatcher matcher;
+    std::vector<std::string> terminals = {"he", "she", "his", "hers", "s", "he"};
+
+    for (size_t i = 0; i < terminals.size(); ++i) {
+        matcher.addPattern(terminals[i], i);
+    }
+
+    matcher.build();
+
+    std::vector<std::tuple<size_t, size_t, size_t>> matches;
+    std::vector<std::tuple<size_t, size_t, size_t>> xptd_matches;
+    const std::string text = "ushers his";
+
+    matcher.findMatches(text, [&](size_t pos, size_t len, size_t nt_code) {
+        matches.emplace_back(pos, len, nt_code);
+    });
+
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        for (size_t i = 0; i < terminals.size(); ++i) {
+            if (text.compare(pos, terminals[i].size(), terminals[i]) == 0) {
+                xptd_matches.emplace_back(pos, terminals[i].size(), i);
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+    std::sort(xptd_matches.begin(), xptd_matches.end());
+
+    ASSERT_EQ(matches, xptd_matches);
+}
+
+TEST(RecognitionSuite, TokenTableTest) {
+    fl::TokenTable table;
+    std::vector<fl::TokenKey> keys;
+
+    // Enough tokens to grow the hash index several times
+    for (size_t i = 0; i < 1000; ++i) {
+        keys.push_back(table.insert("t" + std::to_string(i), fl::TokenType::kTerminal));
+    }
+
+    ASSERT_EQ(table.insert("t7", fl::TokenType::kNonterminal), keys[7]);
+    ASSERT_EQ(table.type(keys[7]), fl::TokenType::kTerminal | fl::TokenType::kNonterminal);
+    ASSERT_EQ(table.ntCount(), 1);
+
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        table.erase(keys[i], fl::TokenType::kTerminal);
+    }
+
+    // The nonterminal part of "t7" is still there
+    table.erase(keys[7], fl::TokenType::kTerminal);
+    ASSERT_EQ(table.token(keys[7]), "t7");
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const auto key = table.find("t" + std::to_string(i));
+
+        if (i % 2 == 0) {
+            ASSERT_FALSE(key.has_value()) << i;
+            ASSERT_EQ(table.type(keys[i]), fl::TokenType::kNothing);
+        } else {
+            ASSERT_EQ(key, keys[i]);
+        }
+    }
+
+    // An erased key is not given out again
+    const auto new_key = table.insert("t0", fl::TokenType::kTerminal);
+
+    ASSERT_EQ(new_key, keys.size());
+    ASSERT_EQ(table.find("t0"), new_key);
+}
+
+TEST(RecognitionSuite, MultirulesMapTest) {
+    fl::MultirulesMap multirules;
+    std::vector<fl::TokenKey> visited;
+
+    multirules[4].push_back({{1}, {0}, std::nullopt});
+    multirules[1];
+
+    // The keys inserted ahead of the iteration are reached, as with std::map
+    for (auto& [nt_key, multirrs] : multirules) {
+        visited.push_back(nt_key);
+
+        if (nt_key == 4) {
+            multirules[100];
+        }
+    }
+
+    ASSERT_EQ(visited, std::vector<fl::TokenKey>({1, 4, 100}));
+    ASSERT_EQ(multirules.size(), 3);
+
+    auto it = multirules.erase(multirules.find(4));
+
+    ASSERT_EQ(it->first, 100);
+    ASSERT_EQ(multirules.find(4), multirules.end());
+    ASSERT_THROW(std::ignore = multirules.at(4), std::out_of_range);
+
+    fl::MultirulesMap copy;
+    copy = multirules;
+
+    ASSERT_EQ(copy.size(), 2);
+    ASSERT_FALSE(copy.try_emplace(1).second);
+}
+
+TEST(RecognitionSuite, BracketsTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/correct_grammar1.txt", cg);
+
+    for (const char* text : {"", "()", "()()", "(()())", "()(())"}) {
+        ASSERT_TRUE(fl::algo::cyk::isRecognized(text, cg)) << text;
+    }
+
+    for (const char* text : {"(", ")(", "(()", "())("}) {
+        ASSERT_FALSE(fl::algo::cyk::isRecognized(text, cg)) << text;
+    }
+}
+
+TEST(RecognitionSuite, PredictionFilterTest) {
+    fl::algo::RecognitionOptions options;
+    options.is_prediction_filtered = true;
+
+    const std::vector<std::pair<const char*, std::vector<std::string>>> cases = {
+        {"assets/correct_grammar1.txt", {"", "()", "()()", "(()())", "()(())", "(", ")(", "(()", "())("}},
+        {"assets/expression_grammar.txt", {"1", "12+0", "(1+2)*20", "((1))*(2+2*0)", "+", "1+", "(1+2", "1*+2"}},
+        {"assets/words_grammar.txt", {"let xy = 1;print xy", "let xy = 1;", "let xy = 1;prx", "print"}}
+    };
+
+    for (const auto& [path, texts] : cases) {
+        CompiledGrammar cg;
+        loadCompiledGrammar(path, cg);
+
+        for (const auto& text : texts) {
+            ASSERT_EQ(fl::algo::cyk::isRecognized(text, cg, options), fl::algo::cyk::isRecognized(text, cg)) << text;
+        }
+
+        // The prediction closure is the left corner relation reversed
+        const auto& ancestors = cg.leftCorners();
+        const auto& descendants = cg.leftDescendants();
+
+        for (size_t a = 0; a < cg.nt_count; ++a) {
+            for (size_t b = 0; b < cg.nt_count; ++b) {
+                ASSERT_EQ(fl::algo::cyk::testBit(descendants.data() + a * cg.nt_words, b),
+                          fl::algo::cyk::testBit(ancestors.data() + b * cg.nt_words, a)) << a << " " << b;
+            }
+        }
+    }
+}
+
+TEST(RecognitionSuite, EarleyTest) {
+    const std::vector<std::pair<const char*, std::vector<std::string>>> cases = {
+        {"assets/correct_grammar1.txt", {"", "()", "()()", "(()())", "()(())", "(", ")(", "(()", "())("}},
+        {"assets/expression_grammar.txt", {"", "1", "12+0", "(1+2)*20", "((1))*(2+2*0)", "+", "1+", "(1+2", "1*+2"}},
+        {"assets/words_grammar.txt", {"let xy = 1;print xy", "let xy = 1;", "let xy = 1;prx", "print"}}
+    };
+
+    for (const auto& [path, texts] : cases) {
+        std::ifstream fin(path);
+        Grammar g;
+
+        ASSERT_NO_THROW(fin >> g);
+
+        fl::algo::earley::EarleyGrammar eg;
+        fl::algo::earley::initEarleyGrammar(eg, g);
+
+        CompiledGrammar cg;
+        loadCompiledGrammar(path, cg);
+
+        for (const auto& text : texts) {
+            ASSERT_EQ(fl::algo::earley::isRecognized(std::string_view(text), eg),
+                      fl::algo::cyk::isRecognized(text, cg)) << text;
+        }
+    }
+}
+
+TEST(RecognitionSuite, ExpressionTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/expression_grammar.txt", cg);
+
+    for (const char* text : {"1", "12+0", "(1+2)*20", "((1))*(2+2*0)"}) {
+        ASSERT_TRUE(fl::algo::cyk::isRecognized(text, cg)) << text;
+    }
+
+    for (const char* text : {"", "+", "1+", "(1+2", "1*+2"}) {
+        ASSERT_FALSE(fl::algo::cyk::isRecognized(text, cg)) << text;
+    }
+}
+
+TEST(RecognitionSuite, SemiringTest) {
+    using fl::algo::BooleanSemiring;
+    using fl::algo::CountingSemiring;
+    using fl::algo::TropicalSemiring;
+    using fl::algo::cyk::evaluate;
+
+    // The weights are kept only without the conversion
+    std::ifstream fin("assets/weighted_grammar.txt");
+    Grammar g;
+
+    ASSERT_NO_THROW(fin >> g);
+    ASSERT_TRUE(fl::algo::isInChomskyForm(g));
+
+    CompiledGrammar cg;
+    fl::algo::initCompiledGrammar(cg, g);
+
+    // Every binary tree over the symbols is a derivation, so there are Catalan numbers of them
+    ASSERT_EQ(evaluate<CountingSemiring>("a", cg), 1u);
+    ASSERT_EQ(evaluate<CountingSemiring>("aaab", cg), 5u);
+    ASSERT_EQ(evaluate<CountingSemiring>("aaaaaaaaaa", cg), 4862u);
+    ASSERT_EQ(evaluate<CountingSemiring>("aca", cg), 0u);
+    ASSERT_EQ(evaluate<CountingSemiring>(std::string(100, 'a'), cg), CountingSemiring::kSaturated);
+
+    ASSERT_DOUBLE_EQ(evaluate<TropicalSemiring>("aaab", cg), 7.5);
+    ASSERT_EQ(evaluate<TropicalSemiring>("", cg), TropicalSemiring::zero());
+
+    ASSERT_TRUE(evaluate<BooleanSemiring>("abba", cg));
+    ASSERT_FALSE(evaluate<BooleanSemiring>("abca", cg));
+
+    CompiledGrammar expression_cg;
+    loadCompiledGrammar("assets/expression_grammar.txt", expression_cg);
+
+    for (const char* text : {"1", "12+0", "(1+2)*20", "((1))*(2+2*0)"}) {
+        ASSERT_EQ(evaluate<CountingSemiring>(text, expression_cg), 1u) << text;
+    }
+
+    ASSERT_EQ(evaluate<CountingSemiring>("1*+2", expression_cg), 0u);
+}
+
+TEST(RecognitionSuite, DerivationCountTest) {
+    using fl::algo::CountingSemiring;
+    using fl::algo::earley::countDerivations;
+
+    auto parseGrammar = [](const std::string& text) {
+        std::istringstream sin(text);
+        Grammar g;
+        sin >> g;
+        return g;
+    };
+
+    // The conversion merges S -> A -> "a" and S -> B -> "a" into one rule S -> "a"
+    const Grammar merged = parseGrammar("S : A | B ;\nA : \"a\" ;\nB : \"a\" ;\n");
+
+    ASSERT_EQ(countDerivations("a", merged), 2u);
+    ASSERT_EQ(countDerivations("b", merged), 0u);
+    ASSERT_EQ(countDerivations("", merged), 0u);
+
+    // B derives the empty string in two ways
+    const Grammar nullable = parseGrammar("S : A \"a\" B ;\nA : \"\" | \"b\" ;\nB : \"\" | C ;\nC : \"\" ;\n");
+
+    ASSERT_EQ(countDerivations("a", nullable), 2u);
+    ASSERT_EQ(countDerivations("ba", nullable), 2u);
+    ASSERT_EQ(countDerivations("ab", nullable), 0u);
+
+    // S =>+ S on the same substring gives infinitely many derivations
+    const Grammar chain_cycle = parseGrammar("S : T | \"a\" ;\nT : S ;\n");
+
+    ASSERT_EQ(countDerivations("a", chain_cycle), CountingSemiring::kSaturated);
+    ASSERT_EQ(countDerivations("aa", chain_cycle), 0u);
+
+    const Grammar nullable_cycle = parseGrammar("S : A S | \"a\" ;\nA : \"\" | \"b\" ;\n");
+
+    ASSERT_EQ(countDerivations("ba", nullable_cycle), CountingSemiring::kSaturated);
+    ASSERT_EQ(countDerivations("bb", nullable_cycle), 0u);
+
+    // The same counts as the CYK engine for a grammar already in CNF
+    std::ifstream fin("assets/weighted_grammar.txt");
+    Grammar weighted;
+
+    ASSERT_NO_THROW(fin >> weighted);
+
+    CompiledGrammar cg;
+    fl::algo::initCompiledGrammar(cg, weighted);
+
+    for (const char* text : {"a", "aaab", "aaaaaaaaaa", "aca"}) {
+        ASSERT_EQ(countDerivations(text, weighted), fl::algo::cyk::evaluate<CountingSemiring>(text, cg)) << text;
+    }
+
+    const Grammar expression = parseGrammar("E : E \"+\" E | \"1\" ;\n");
+
+    ASSERT_EQ(countDerivations("1+1+1+1", expression), 5u);
+}
+
+TEST(RecognitionSuite, ParseForestTest) {
+    using fl::algo::cyk::ParseForest;
+
+    // An ambiguous grammar, the weights do not matter here
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/weighted_grammar.txt", cg);
+
+    for (const char* text : {"a", "ab", "abbaabab", "babababbaa", "", "abc"}) {
+        ParseForest forest;
+        fl::algo::cyk::buildParseForest(forest, text, cg);
+
+        ASSERT_EQ(!forest.empty(), fl::algo::cyk::isRecognized(text, cg)) << text;
+
+        // The children are always shorter, so the shorter nodes are counted first
+        std::vector<size_t> order(forest.nodes.size());
+        std::vector<uint64_t> trees_counts(forest.nodes.size(), 0);
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return forest.nodes[a].end - forest.nodes[a].begin < forest.nodes[b].end - forest.nodes[b].begin;
+        });
+
+        for (size_t i : order) {
+            const auto& node = forest.nodes[i];
+
+            for (size_t f = node.families_begin; f < node.families_end; ++f) {
+                const auto& family = forest.families[f];
+
+                if (family.left == ParseForest::kNoNode) {
+                    ++trees_counts[i];
+                } else {
+                    trees_counts[i] += trees_counts[family.left] * trees_counts[family.right];
+                }
+            }
+        }
+
+        const uint64_t trees_count = forest.empty() ? 0 : trees_counts[forest.root];
+
+        ASSERT_EQ(trees_count, fl::algo::cyk::evaluate<fl::algo::CountingSemiring>(text, cg)) << text;
+    }
+}
+
+TEST(RecognitionSuite, RandomGrammarTest) {
+    // The grammar has cycles of chain rules and many terminal rules per nonterminal
+    std::ifstream fin("assets/random_grammar.txt");
+    Grammar g;
+
+    ASSERT_NO_THROW(fin >> g);
+
+    fl::algo::earley::EarleyGrammar eg;
+    fl::algo::earley::initEarleyGrammar(eg, g);
+
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/random_grammar.txt", cg);
+
+    for (const char* text : {"baadaaaddaad", "daddcdcabbdd", "baaadd", "aacdaa",
+                             "", "c", "ddd", "cccccccc", "abcdabcdabcd", "bbbbbbbbbbbbbbbbbbbc"}) {
+        ASSERT_EQ(fl::algo::cyk::isRecognized(text, cg), fl::algo::earley::isRecognized(text, eg)) << text;
+    }
+}
+
+TEST(RecognitionSuite, StatisticsTest) {
+    std::ifstream fin("assets/correct_grammar1.txt");
+    Grammar g;
+
+    ASSERT_NO_THROW(fin >> g);
+
+    fl::algo::ConversionStatistics conversion;
+    fl::algo::convertToChomskyForm(g, 0, &conversion);
+
+    ASSERT_EQ(conversion.passes.size(), 9);
+    ASSERT_EQ(conversion.passes.back().nonterminals_after, g.multirules.size());
+
+    for (size_t i = 1; i < conversion.passes.size(); ++i) {
+        ASSERT_EQ(conversion.passes[i].rules_before, conversion.passes[i - 1].rules_after);
+    }
+
+    CompiledGrammar cg;
+    fl::algo::initCompiledGrammar(cg, g);
+
+    // Every bracket is matched by a terminal rule, so the fill visits all 6 cells longer than a symbol
+    fl::algo::RecognitionStatistics recognition;
+    fl::algo::RecognitionOptions options;
+    options.statistics = &recognition;
+
+    ASSERT_TRUE(fl::algo::cyk::isRecognized("()()", cg, options));
+    ASSERT_EQ(recognition.chart_bytes, fl::algo::cyk::Chart(4, cg.nt_count).bytes());
+    ASSERT_EQ(recognition.cells_touched, 6);
+
+    // The prediction never visits more cells
+    options.is_prediction_filtered = true;
+
+    ASSERT_TRUE(fl::algo::cyk::isRecognized("()()", cg, options));
+    ASSERT_LE(recognition.cells_touched, 6);
+}
+
+TEST(RecognitionSuite, ConversionPhasesTest) {
+    std::ifstream fin("assets/correct_grammar1.txt");
+    Grammar g;
+
+    ASSERT_NO_THROW(fin >> g);
+
+    // The grammar has no useless nonterminals, so the second "unreachable" has nothing to do
+    Grammar first_phase = g;
+    fl::algo::ConversionStatistics conversion;
+    fl::algo::convertToChomskyForm(first_phase, 1, &conversion);
+
+    ASSERT_EQ(conversion.passes.size(), 3);
+    ASSERT_FALSE(conversion.passes[0].is_skipped);
+    ASSERT_TRUE(conversion.passes[2].is_skipped);
+    ASSERT_EQ(first_phase.multirules.size(), g.multirules.size());
+
+    fl::algo::convertToChomskyForm(g, 0);
+
+    ASSERT_TRUE(fl::algo::isInChomskyForm(g));
+}
+
+TEST(RecognitionSuite, PartialConversionTest) {
+    std::ifstream fin("assets/expression_grammar.txt");
+    Grammar g;
+
+    ASSERT_NO_THROW(fin >> g);
+
+    // A grammar converted only partially is not in CNF and must not be compiled
+    for (int end_phase = 1; end_phase <= 3; ++end_phase) {
+        Grammar partial = g;
+        fl::algo::convertToChomskyForm(partial, end_phase);
+
+        ASSERT_FALSE(fl::algo::isInChomskyForm(partial)) << end_phase;
+
+        CompiledGrammar cg;
+        ASSERT_THROW(fl::algo::initCompiledGrammar(cg, partial), std::invalid_argument) << end_phase;
+    }
+}
+
+TEST(RecognitionSuite, ThreadsTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/correct_grammar1.txt", cg);
+
+    fl::algo::RecognitionOptions options;
+    options.threads_count = 4;
+
+    ASSERT_TRUE(fl::algo::cyk::isRecognized(getNestedBrackets(150), cg, options));
+    ASSERT_FALSE(fl::algo::cyk::isRecognized(getNestedBrackets(150) + "(", cg, options));
+}
+
+TEST(RecognitionSuite, TokenLevelTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/words_grammar.txt", cg);
+
+    fl::algo::RecognitionOptions options;
+    options.is_token_level = true;
+
+    for (const char* text : {"print 1;", "let xy = x + 12;print xy;"}) {
+        ASSERT_TRUE(fl::algo::cyk::isRecognized(text, cg, options)) << text;
+        ASSERT_TRUE(fl::algo::valiant::isRecognized(text, cg, options)) << text;
+    }
+
+    for (const char* text : {"print x", "let x y = 1;", "print 1 + ;", "print  1;"}) {
+        ASSERT_FALSE(fl::algo::cyk::isRecognized(text, cg, options)) << text;
+        ASSERT_FALSE(fl::algo::valiant::isRecognized(text, cg, options)) << text;
+    }
+}
+
+TEST(RecognitionSuite, IncrementalTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/expression_grammar.txt", cg);
+
+    fl::algo::cyk::IncrementalRecognizer recognizer(cg);
+    std::string text;
+
+    ASSERT_FALSE(recognizer.isRecognized());
+
+    for (const char* chunk : {"(1", "", "+", "20)", "*", "(2*(1+1))", "+0", "+"}) {
+        text += chunk;
+        recognizer.append(chunk);
+
+        ASSERT_EQ(recognizer.size(), text.size());
+        ASSERT_EQ(recognizer.isRecognized(), fl::algo::cyk::isRecognized(text, cg)) << text;
+    }
+
+    recognizer.clear();
+    recognizer.append("12");
+
+    ASSERT_TRUE(recognizer.isRecognized());
+}
+
+TEST(RecognitionSuite, ViablePrefixTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/expression_grammar.txt", cg);
+
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("", cg), 0);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("((1+2", cg), 5);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("(1+)", cg), 3);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("1+2)*3", cg), 3);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("*1", cg), 0);
+
+    CompiledGrammar words_cg;
+    loadCompiledGrammar("assets/words_grammar.txt", words_cg);
+
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("let xy = 1", words_cg), 10);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("let xy = 1;pri", words_cg), 14);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("let xy = 1;prx", words_cg), 13);
+    ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix("let xy : 1", words_cg), 7);
+}
+
+TEST(RecognitionSuite, ValiantMatchesCYKTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/expression_grammar.txt", cg);
+
+    std::vector<std::string> texts = {"", "1", "(1+2)*20", "1+"};
+    std::string long_text = "1";
+
+    for (size_t i = 0; i < 60; ++i) {
+        long_text = "(" + long_text + (i % 2 == 0 ? ")*2" : ")+10");
+    }
+
+    texts.push_back(long_text);
+    texts.push_back(long_text + "+");
+    texts.push_back("(" + long_text);
+
+    fl::algo::RecognitionOptions options;
+
+    for (auto kernel : {fl::algo::RecognitionOptions::ProductKernel::kNaive,
+                        fl::algo::RecognitionOptions::ProductKernel::kFourRussians}) {
+        options.kernel = kernel;
+
+        for (const auto& text : texts) {
+            ASSERT_EQ(fl::algo::valiant::isRecognized(text, cg, options),
+                      fl::algo::cyk::isRecognized(text, cg)) << text;
+        }
+    }
+}
+
+TEST(RecognitionSuite, TriangularBitMatrixTest) {
+    using fl::algo::BitRange;
+    using fl::algo::kBitTileSize;
+
+    std::mt19937_64 random(7);
+
+    fl::algo::BitTile tile, transposed;
+
+    for (auto& row : tile.rows) {
+        row = random();
+    }
+
+    fl::algo::transposeTile(transposed, tile);
+
+    for (size_t r = 0; r < kBitTileSize; ++r) {
+        for (size_t c = 0; c < kBitTileSize; ++c) {
+            ASSERT_EQ((transposed.rows[c] >> r) & 1u, (tile.rows[r] >> c) & 1u) << r << " " << c;
+        }
+    }
+
+    const size_t tiles_count = 5;
+    const size_t size = tiles_count * kBitTileSize;
+    fl::algo::TriangularBitMatrix a(tiles_count), b(tiles_count);
+
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = i / kBitTileSize * kBitTileSize; j < size; ++j) {
+            if (random() % 7 == 0) {
+                a.set(i, j);
+            }
+
+            if (random() % 5 == 0) {
+                b.set(i, j);
+            }
+        }
+    }
+
+    const BitRange rows{0, 2}, mids{2, 3}, cols{3, 5};
+
+    for (auto kernel : {fl::algo::multiplyAdd, fl::algo::multiplyAddFourRussians}) {
+        fl::algo::TriangularBitMatrix product(tiles_count);
+        kernel(product, a, b, rows, mids, cols);
+
+        for (size_t i = rows.begin * kBitTileSize; i < rows.end * kBitTileSize; ++i) {
+            for (size_t j = cols.begin * kBitTileSize; j < cols.end * kBitTileSize; ++j) {
+                bool xptd = false;
+
+                for (size_t k = mids.begin * kBitTileSize; k < mids.end * kBitTileSize; ++k) {
+                    xptd = xptd || (a.test(i, k) && b.test(k, j));
+                }
+
+                ASSERT_EQ(product.test(i, j), xptd) << i << " " << j;
+            }
+        }
+    }
+}
+
+TEST(RecognitionSuite, CompiledGrammarFileTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/words_grammar.txt", cg);
+
+    const char* const path = "compiled_words_grammar.bin";
+
+    {
+        std::ofstream fout(path, std::ios::binary);
+        ASSERT_TRUE(fout.good());
+        fl::algo::saveCompiledGrammar(fout, cg);
+    }
+
+    CompiledGrammar loaded_cg;
+
+    {
+        fl::MappedFile file(path);
+        ASSERT_TRUE(fl::algo::isCompiledGrammarFile(file.view()));
+        ASSERT_NO_THROW(fl::algo::initCompiledGrammar(loaded_cg, file));
+    }
+
+    std::remove(path);
+
+    ASSERT_EQ(loaded_cg.nt_count, cg.nt_count);
+    ASSERT_EQ(loaded_cg.start_code, cg.start_code);
+    ASSERT_EQ(loaded_cg.nt_names, cg.nt_names);
+    ASSERT_EQ(loaded_cg.heads, cg.heads);
+    ASSERT_EQ(loaded_cg.leftCorners(), cg.leftCorners());
+
+    for (const std::string text : {"let xy = 1;print xy", "let xy = 1;", "let xy = 1;prx", ""}) {
+        ASSERT_EQ(fl::algo::cyk::isRecognized(text, loaded_cg), fl::algo::cyk::isRecognized(text, cg)) << text;
+        ASSERT_EQ(fl::algo::cyk::findLongestViablePrefix(text, loaded_cg),
+                  fl::algo::cyk::findLongestViablePrefix(text, cg)) << text;
+    }
+
+    fl::MappedFile grammar_file("assets/words_grammar.txt");
+
+    ASSERT_FALSE(fl::algo::isCompiledGrammarFile(grammar_file.view()));
+    ASSERT_THROW(fl::algo::initCompiledGrammar(loaded_cg, grammar_file), std::runtime_error);
+}
+
+TEST(RecognitionSuite, CorruptedCompiledGrammarFileTest) {
+    CompiledGrammar cg;
+    loadCompiledGrammar("assets/words_grammar.txt", cg);
+
+    std::ostringstream sout;
+    fl::algo::saveCompiledGrammar(sout, cg);
+    const std::string original = sout.str();
+
+    const char* const path = "corrupted_words_grammar.bin";
+    size_t rejected_count = 0;
+
+    // Every word of the file gets an out of range value in its turn: the file is either
+    // rejected or still safe to recognize with (a weight or a name may take any value)
+    for (size_t offset = sizeof(uint64_t); offset + sizeof(uint64_t) <= original.size(); offset += sizeof(uint64_t)) {
+        std::string corrupted = original;
+        const uint64_t value = cg.nt_count + 1;
+        std::memcpy(corrupted.data() + offset, &value, sizeof(value));
+
+        {
+            std::ofstream fout(path, std::ios::binary);
+            ASSERT_TRUE(fout.good());
+            fout << corrupted;
+        }
+
+        CompiledGrammar loaded_cg;
+
+        try {
+            fl::MappedFile file(path);
+            fl::algo::initCompiledGrammar(loaded_cg, file);
+        } catch (const std::runtime_error&) {
+            ++rejected_count;
+            continue;
+        }
+
+        for (const std::string text : {"let xy = 1;print xy", "let xy = 1;prx"}) {
+            fl::algo::cyk::isRecognized(text, loaded_cg);
+            fl::algo::cyk::findLongestViablePrefix(text, loaded_cg);
+        }
+    }
+
+    std::remove(path);
+
+    ASSERT_GT(rejected_count, 0u);
+}
+
+TEST(RecognitionSuite, BitKernelsTest) {
+    using fl::algo::SimdLevel;
+
+    std::mt19937_64 random(42);
+    const auto& scalar = fl::algo::getBitKernels(SimdLevel::kScalar);
+
+    for (auto level : {SimdLevel::kAVX2, SimdLevel::kAVX512}) {
+        if (level > fl::algo::detectSimdLevel()) {
+            continue;
+        }
+
+        const auto& kernels = fl::algo::getBitKernels(level);
+
+        ASSERT_EQ(kernels.level, level);
+
+        // The sizes around the vector widths, the offsets break the alignment
+        for (size_t words : {0, 1, 3, 4, 5, 8, 9, 17, 79}) {
+            for (size_t offset : {0, 1}) {
+                std::vector<uint64_t> a(words + offset), b(words + offset);
+
+                for (size_t w = 0; w < words + offset; ++w) {
+                    a[w] = random();
+                    b[w] = random() & random() & random();
+                }
+
+                // A single common bit in the last word only
+                std::vector<uint64_t> c(words + offset, 0), d(words + offset, 0), zero(words + offset, 0);
+
+                if (words != 0) {
+                    c.back() = d.back() = uint64_t{1} << 63;
+                }
+
+                for (const auto* x : {&a, &b, &c, &zero}) {
+                    for (const auto* y : {&a, &b, &c, &d}) {
+                        ASSERT_EQ(kernels.intersects(x->data() + offset, y->data() + offset, words),
+                                  scalar.intersects(x->data() + offset, y->data() + offset, words));
+                        ASSERT_EQ(kernels.covers(x->data() + offset, y->data() + offset, words),
+                                  scalar.covers(x->data() + offset, y->data() + offset, words));
+
+                        std::vector<uint64_t> expected_and(words + offset, 0), result_and(words + offset, 0);
+
+                        ASSERT_EQ(kernels.and_words(result_and.data() + offset, x->data() + offset, y->data() + offset, words),
+                                  scalar.and_words(expected_and.data() + offset, x->data() + offset, y->data() + offset, words));
+                        ASSERT_EQ(result_and, expected_and);
+                    }
+
+                    ASSERT_EQ(kernels.is_empty(x->data() + offset, words),
+                              scalar.is_empty(x->data() + offset, words));
+                }
+
+                auto expected = a;
+                auto result = a;
+                scalar.or_words(expected.data() + offset, b.data() + offset, words);
+                kernels.or_words(result.data() + offset, b.data() + offset, words);
+
+                ASSERT_EQ(result, expected);
+            }
+        }
+    }
+}
+
+TEST(RecognitionSuite, TextInputTest) {
+    const std::string content = "let xy = 1;\nprint xy";
+
+    // A regular file is mapped
+    const char* const path = "text_input.txt";
+
+    {
+        std::ofstream fout(path, std::ios::binary);
+        ASSERT_TRUE(fout.good());
+        fout << content;
+    }
+
+    {
+        fl::TextInput input(path);
+        ASSERT_EQ(input.view(), content);
+    }
+
+    // An empty file can't be mapped, its view is empty
+    {
+        std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+        ASSERT_TRUE(fout.good());
+    }
+
+    {
+        fl::TextInput input(path);
+        ASSERT_TRUE(input.view().empty());
+    }
+
+    std::remove(path);
+
+    // A pipe has no size, it is read into the buffer
+    const char* const fifo_path = "text_input.fifo";
+    std::remove(fifo_path);
+
+    ASSERT_EQ(::mkfifo(fifo_path, 0600), 0);
+
+    std::thread writer([&] {
+        std::ofstream fout(fifo_path, std::ios::binary);
+        fout << content;
+    });
+
+    std::string read_content;
+
+    try {
+        fl::TextInput input(fifo_path);
+        read_content = input.view();
+    } catch (...) {
+    }
+
+    writer.join();
+    std::remove(fifo_path);
+
+    ASSERT_EQ(read_content, content);
+
+    ASSERT_THROW(fl::TextInput("assets/no_such_text.txt"), std::system_error);
+}
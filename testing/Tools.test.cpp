@@ -0,0 +1,208 @@
+#include "RandomGrammar.h"
+#include "SentenceSampler.h"
+
+#include "CYK_Algorithm.h"
+#include "GrammarAlgorithms.h"
+
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+
+using fl::Grammar;
+using fl::algo::CompiledGrammar;
+
+
+namespace {
+    std::vector<fl::tools::RandomGrammarOptions> getRandomGrammarOptions() {
+        std::vector<fl::tools::RandomGrammarOptions> all_options;
+
+        for (uint64_t seed = 1; seed <= 8; ++seed) {
+            fl::tools::RandomGrammarOptions options;
+            options.seed = seed;
+            options.nullable_density = 0.05 * static_cast<double>(seed % 4);
+            options.chain_depth = seed % 3;
+            options.ambiguity = 0.1 * static_cast<double>(seed % 2);
+            all_options.push_back(options);
+        }
+
+        return all_options;
+    }
+
+    void compileGrammar(Grammar g, CompiledGrammar& cg) {
+        fl::algo::convertToChomskyForm(g, 0);
+        fl::algo::initCompiledGrammar(cg, g);
+    }
+
+    // The nonterminals of the sequence of a right side
+    std::vector<fl::TokenKey> getNonterminals(const fl::RuleRightSide& rrs) {
+        std::vector<fl::TokenKey> nonterminals;
+
+        for (size_t index : rrs.nt_indexes) {
+            nonterminals.push_back(rrs.sequence[index]);
+        }
+
+        return nonterminals;
+    }
+}
+
+
+TEST(ToolsSuite, RandomGrammarTest) {
+    for (const auto& options : getRandomGrammarOptions()) {
+        Grammar g;
+        Grammar same_g;
+        fl::tools::generateRandomGrammar(g, options);
+        fl::tools::generateRandomGrammar(same_g, options);
+
+        ASSERT_EQ(g.toString(), same_g.toString()) << options.seed;
+        ASSERT_EQ(g.multirules.size(), options.nt_count) << options.seed;
+
+        // Every nonterminal is generative: a fixed point over the right sides
+        std::vector<char> is_generative(g.tntable.keysEnd(), false);
+
+        for (bool is_changed = true; is_changed;) {
+            is_changed = false;
+
+            for (const auto& [key, rules] : g.multirules) {
+                if (is_generative[key]) {
+                    continue;
+                }
+
+                for (const auto& rrs : rules) {
+                    bool is_rule_generative = true;
+
+                    for (fl::TokenKey nt_key : getNonterminals(rrs)) {
+                        is_rule_generative = is_rule_generative && is_generative[nt_key];
+                    }
+
+                    if (is_rule_generative) {
+                        is_generative[key] = is_changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // And reachable from the start
+        std::vector<char> is_reachable(g.tntable.keysEnd(), false);
+        std::vector<fl::TokenKey> stack = {g.start};
+        is_reachable[g.start] = true;
+
+        while (!stack.empty()) {
+            const fl::TokenKey key = stack.back();
+            stack.pop_back();
+
+            for (const auto& rrs : g.multirules.at(key)) {
+                for (fl::TokenKey nt_key : getNonterminals(rrs)) {
+                    if (!is_reachable[nt_key]) {
+                        is_reachable[nt_key] = true;
+                        stack.push_back(nt_key);
+                    }
+                }
+            }
+        }
+
+        for (const auto& [key, rules] : g.multirules) {
+            ASSERT_TRUE(is_generative[key]) << options.seed << ' ' << g.tntable.token(key);
+            ASSERT_TRUE(is_reachable[key]) << options.seed << ' ' << g.tntable.token(key);
+        }
+
+        // So the grammar in the Chomsky form still generates something
+        CompiledGrammar cg;
+        compileGrammar(g, cg);
+
+        ASSERT_FALSE(cg.empty()) << options.seed;
+    }
+
+    // A different seed gives a different grammar
+    Grammar g;
+    Grammar other_g;
+    fl::tools::RandomGrammarOptions options;
+    fl::tools::generateRandomGrammar(g, options);
+    options.seed += 1;
+    fl::tools::generateRandomGrammar(other_g, options);
+
+    ASSERT_NE(g.toString(), other_g.toString());
+
+    options.terminals_count = 0;
+
+    ASSERT_THROW(fl::tools::generateRandomGrammar(g, options), std::invalid_argument);
+}
+
+TEST(ToolsSuite, SentenceSamplerTest) {
+    static const size_t kMaxLength = 12;
+    static const size_t kSamplesCount = 8;
+
+    std::mt19937_64 rng(42);
+    size_t near_misses_count = 0;
+
+    for (const auto& options : getRandomGrammarOptions()) {
+        Grammar g;
+        fl::tools::generateRandomGrammar(g, options);
+
+        CompiledGrammar cg;
+        compileGrammar(g, cg);
+
+        fl::tools::SentenceSampler sampler(cg, kMaxLength);
+        size_t sampled_lengths_count = 0;
+
+        for (size_t length = 0; length <= kMaxLength; ++length) {
+            if (!sampler.hasSentences(length)) {
+                ASSERT_THROW(sampler.sample(length, rng), std::invalid_argument);
+                continue;
+            }
+
+            ++sampled_lengths_count;
+
+            for (size_t i = 0; i < kSamplesCount; ++i) {
+                const std::string sentence = sampler.sample(length, rng);
+
+                ASSERT_EQ(sentence.size(), length) << options.seed;
+                ASSERT_TRUE(fl::algo::cyk::isRecognized(sentence, cg)) << options.seed << ' ' << sentence;
+
+                std::string near_miss;
+
+                if (sampler.sampleNearMiss(length, rng, near_miss)) {
+                    ++near_misses_count;
+                    ASSERT_FALSE(fl::algo::cyk::isRecognized(near_miss, cg)) << options.seed << ' ' << near_miss;
+                }
+            }
+        }
+
+        ASSERT_GT(sampled_lengths_count, 0u) << options.seed;
+        ASSERT_EQ(sampler.hasSentences(0), cg.generates_empty) << options.seed;
+        ASSERT_FALSE(sampler.hasSentences(kMaxLength + 1));
+    }
+
+    ASSERT_GT(near_misses_count, 0u);
+}
+
+TEST(ToolsSuite, EmptySentenceTest) {
+    // The only sentence of the grammar is the empty one
+    std::istringstream sin("S : \"\" ;\n");
+    Grammar g;
+
+    ASSERT_NO_THROW(sin >> g);
+
+    CompiledGrammar cg;
+    compileGrammar(g, cg);
+
+    ASSERT_TRUE(cg.generates_empty);
+
+    fl::tools::SentenceSampler sampler(cg, 4);
+    std::mt19937_64 rng(1);
+
+    ASSERT_TRUE(sampler.hasSentences(0));
+    ASSERT_FALSE(sampler.hasSentences(1));
+    ASSERT_EQ(sampler.sample(0, rng), "");
+
+    // Any character makes a near miss of it
+    std::string near_miss;
+
+    ASSERT_TRUE(sampler.sampleNearMiss(0, rng, near_miss));
+    ASSERT_FALSE(fl::algo::cyk::isRecognized(near_miss, cg));
+}
@@ -0,0 +1,122 @@
+#include "RandomGrammar.h"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // The std distributions differ between the standard libraries, so they are not used
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : m_rng(seed) {
+        }
+
+        size_t next(size_t bound) {
+            return static_cast<size_t>(m_rng() % bound);
+        }
+
+        bool chance(double probability) {
+            return static_cast<double>(m_rng() >> 11) * 0x1.0p-53 < probability;
+        }
+
+    private:
+        std::mt19937_64 m_rng;
+    };
+
+    std::string getNonterminalName(size_t index) {
+        return "n" + std::to_string(index);
+    }
+}  // namespace
+
+namespace fl::tools {
+    void generateRandomGrammar(Grammar& g, const RandomGrammarOptions& options) {
+        if (options.nt_count == 0 || options.rules_count == 0 || options.max_rule_length == 0) {
+            throw std::invalid_argument("a grammar needs at least one nonterminal, right side and symbol.\n");
+        }
+
+        if (options.terminals_count == 0 || options.terminals_count > 26) {
+            throw std::invalid_argument("the number of terminals must be from 1 to 26.\n");
+        }
+
+        g.clear();
+
+        GrammarBuilder builder(g);
+        Random random(options.seed);
+
+        // The adjacent terminals are glued into one, the same way the grammar parser does
+        std::string terminal_buf;
+
+        auto flushTerminalBuffer = [&]() {
+            if (!terminal_buf.empty()) {
+                builder.pushToken(std::move(terminal_buf), TokenType::kTerminal);
+                terminal_buf.clear();
+            }
+        };
+
+        auto pushTerminal = [&]() {
+            terminal_buf += static_cast<char>('a' + random.next(options.terminals_count));
+        };
+
+        auto pushNonterminal = [&](size_t index) {
+            flushTerminalBuffer();
+            builder.pushToken(getNonterminalName(index), TokenType::kNonterminal);
+        };
+
+        auto pushRandomSymbol = [&]() {
+            if (random.chance(0.5)) {
+                pushNonterminal(random.next(options.nt_count));
+            } else {
+                pushTerminal();
+            }
+        };
+
+        for (size_t i = 0; i < options.nt_count; ++i) {
+            builder.addRule(getNonterminalName(i));
+
+            // The right side that keeps n(i + 1) reachable and n(i) generative
+            builder.addRuleRightSide();
+
+            if (i + 1 == options.nt_count) {
+                for (size_t len = 1 + random.next(options.max_rule_length); len > 0; --len) {
+                    pushTerminal();
+                }
+            } else if (i % (options.chain_depth + 1) < options.chain_depth) {
+                pushNonterminal(i + 1);
+            } else {
+                const size_t len = 1 + random.next(options.max_rule_length);
+                const size_t next_nt_pos = random.next(len);
+
+                for (size_t pos = 0; pos < len; ++pos) {
+                    if (pos == next_nt_pos) {
+                        pushNonterminal(i + 1);
+                    } else {
+                        pushTerminal();
+                    }
+                }
+            }
+
+            flushTerminalBuffer();
+
+            for (size_t r = 1; r < options.rules_count; ++r) {
+                builder.addRuleRightSide();
+
+                for (size_t len = 1 + random.next(options.max_rule_length); len > 0; --len) {
+                    pushRandomSymbol();
+                }
+
+                flushTerminalBuffer();
+            }
+
+            if (random.chance(options.nullable_density)) {
+                builder.addRuleRightSide();
+                builder.pushToken("", TokenType::kTerminal);
+            }
+
+            if (random.chance(options.ambiguity)) {
+                builder.addRuleRightSide();
+                pushNonterminal(i);
+                pushNonterminal(i);
+            }
+        }
+    }
+}  // namespace fl::tools
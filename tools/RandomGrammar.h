@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Grammar.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fl::tools {
+    /**
+     * nt_count - the number of nonterminals n0, n1, ..., n0 is the start
+     * rules_count - the number of right sides of every nonterminal, not counting the extra ones below
+     * max_rule_length - the longest right side
+     * terminals_count - the terminals are the letters from 'a'
+     * nullable_density - the probability of a nonterminal to have an empty right side
+     * chain_depth - the length of the runs of chain rules n(i) -> n(i + 1)
+     * ambiguity - the probability of a nonterminal to have the right side "n(i) n(i)"
+     */
+    struct RandomGrammarOptions {
+        size_t nt_count{8};
+        size_t rules_count{3};
+        size_t max_rule_length{4};
+        size_t terminals_count{4};
+        double nullable_density{0.1};
+        size_t chain_depth{0};
+        double ambiguity{0.0};
+        uint64_t seed{1};
+    };
+
+    /**
+     * Generates a random grammar in which every nonterminal is reachable and generative:
+     * the first right side of n(i) refers to n(i + 1) and the last nonterminal
+     * has a terminal right side. The same options and seed give the same grammar.
+     *
+     * Throws std::invalid_argument for the options that can't make a grammar.
+     */
+    void generateRandomGrammar(Grammar& g, const RandomGrammarOptions& options);
+}  // namespace fl::tools
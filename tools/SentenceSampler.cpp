@@ -0,0 +1,182 @@
+#include "SentenceSampler.h"
+
+#include "CYK_Algorithm.h"
+
+#include <algorithm>
+#include <optional>
+#include <stack>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+    // The std distributions differ between the standard libraries, so they are not used
+    long double getUniform(std::mt19937_64& rng) {
+        return static_cast<long double>(rng() >> 11) * 0x1.0p-53L;
+    }
+}  // namespace
+
+namespace fl::tools {
+    SentenceSampler::SentenceSampler(const algo::CompiledGrammar& cg, size_t max_length)
+        : m_cg(cg)
+        , m_max_length(max_length)
+        , m_counts((max_length + 1) * cg.nt_count, 0)
+        , m_head_offsets(cg.nt_count + 1, 0) {
+        for (size_t h = 0; h < cg.heads.size(); ++h) {
+            ++m_head_offsets[cg.heads[h] + 1];
+        }
+
+        for (size_t a = 0; a < cg.nt_count; ++a) {
+            m_head_offsets[a + 1] += m_head_offsets[a];
+        }
+
+        m_head_pairs.resize(cg.heads.size());
+        std::vector<size_t> next(m_head_offsets.begin(), m_head_offsets.end() - 1);
+
+        for (const auto& pair : cg.pairs) {
+            for (size_t h = pair.heads_begin; h < pair.heads_end; ++h) {
+                m_head_pairs[next[cg.heads[h]]++] = {pair.left, pair.right};
+            }
+        }
+
+        for (const auto& rule : cg.terminal_rules) {
+            if (rule.terminal.size() <= max_length) {
+                m_counts[rule.terminal.size() * cg.nt_count + rule.nt_code] += 1;
+            }
+
+            m_alphabet += rule.terminal;
+        }
+
+        // The empty string has the single derivation S -> ""
+        if (cg.generates_empty) {
+            m_counts[cg.start_code] = 1;
+        }
+
+        std::sort(m_alphabet.begin(), m_alphabet.end());
+        m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+
+        // In CNF only the start may generate the empty string, and it is never a child
+        for (size_t len = 2; len <= max_length; ++len) {
+            for (size_t a = 0; a < cg.nt_count; ++a) {
+                long double& a_count = m_counts[len * cg.nt_count + a];
+
+                for (size_t p = m_head_offsets[a]; p < m_head_offsets[a + 1]; ++p) {
+                    const auto [b_nt_code, c_nt_code] = m_head_pairs[p];
+
+                    for (size_t k = 1; k < len; ++k) {
+                        a_count += count(b_nt_code, k) * count(c_nt_code, len - k);
+                    }
+                }
+            }
+        }
+    }
+
+    bool SentenceSampler::hasSentences(size_t length) const noexcept {
+        return !m_cg.empty() && length <= m_max_length && count(m_cg.start_code, length) > 0;
+    }
+
+    std::string SentenceSampler::sample(size_t length, std::mt19937_64& rng) const {
+        if (!hasSentences(length)) {
+            throw std::invalid_argument("the grammar has no sentences of the length.\n");
+        }
+
+        if (length == 0) {
+            return {};
+        }
+
+        std::string sentence;
+
+        // The nodes are expanded left to right, so the terminals come in the order of the sentence
+        std::stack<std::pair<size_t, size_t>> nodes;
+        nodes.emplace(m_cg.start_code, length);
+
+        while (!nodes.empty()) {
+            const auto [a, len] = nodes.top();
+            nodes.pop();
+
+            // The last possible option is taken if the rounding leaves a bit of the choice
+            long double choice = getUniform(rng) * count(a, len);
+            const std::string* terminal = nullptr;
+
+            for (const auto& rule : m_cg.terminal_rules) {
+                if (rule.nt_code == a && rule.terminal.size() == len) {
+                    terminal = &rule.terminal;
+                    choice -= 1;
+
+                    if (choice < 0) {
+                        break;
+                    }
+                }
+            }
+
+            if (choice < 0) {
+                sentence += *terminal;
+                continue;
+            }
+
+            std::optional<std::tuple<size_t, size_t, size_t>> split;
+
+            for (size_t p = m_head_offsets[a]; p < m_head_offsets[a + 1] && choice >= 0; ++p) {
+                const auto [b_nt_code, c_nt_code] = m_head_pairs[p];
+
+                for (size_t k = 1; k < len && choice >= 0; ++k) {
+                    const long double option = count(b_nt_code, k) * count(c_nt_code, len - k);
+
+                    if (option > 0) {
+                        split.emplace(b_nt_code, c_nt_code, k);
+                        choice -= option;
+                    }
+                }
+            }
+
+            if (split) {
+                const auto [b_nt_code, c_nt_code, k] = *split;
+                nodes.emplace(c_nt_code, len - k);
+                nodes.emplace(b_nt_code, k);
+            } else if (terminal != nullptr) {
+                sentence += *terminal;
+            } else {
+                throw std::logic_error("the derivation counts are broken.\n");
+            }
+        }
+
+        return sentence;
+    }
+
+    bool SentenceSampler::sampleNearMiss(size_t length, std::mt19937_64& rng, std::string& sentence) const {
+        // A few sentences may have no near misses at all, as a* has none for a*
+        static const size_t kAttemptsCount = 64;
+
+        for (size_t attempt = 0; attempt < kAttemptsCount; ++attempt) {
+            sentence = sample(length, rng);
+
+            const size_t pos = rng() % (sentence.size() + 1);
+            const char ch = m_alphabet.empty() ? 'a' : m_alphabet[rng() % m_alphabet.size()];
+
+            switch (rng() % 3) {
+                case 0:
+                    if (pos == sentence.size()) {
+                        continue;
+                    }
+
+                    sentence[pos] = ch;
+                    break;
+                case 1:
+                    sentence.insert(sentence.begin() + static_cast<ssize_t>(pos), ch);
+                    break;
+                default:
+                    if (pos == sentence.size()) {
+                        continue;
+                    }
+
+                    sentence.erase(sentence.begin() + static_cast<ssize_t>(pos));
+                    break;
+            }
+
+            if (!algo::cyk::isRecognized(sentence, m_cg)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}  // namespace fl::tools
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CompiledGrammar.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fl::tools {
+    /**
+     * SentenceSampler draws the sentences of a given length from a grammar in CNF
+     * uniformly over their derivations: count(A, len) is the number of derivations
+     * of the strings of len characters from A, and every choice of a rule and a split
+     * is taken with the probability proportional to the derivations it leads to.
+     *
+     * For an unambiguous grammar it is the uniform distribution over the sentences.
+     * The counts are kept as long double, so only their ratios are exact.
+     */
+    class SentenceSampler {
+    public:
+        SentenceSampler(const algo::CompiledGrammar& cg, size_t max_length);
+
+        // Whether the grammar has a sentence of the length
+        [[nodiscard]] bool hasSentences(size_t length) const noexcept;
+
+        std::string sample(size_t length, std::mt19937_64& rng) const;
+
+        /**
+         * Changes one character of a sampled sentence (replaces, inserts or removes it)
+         * until the grammar stops generating it. The characters are taken from the terminals.
+         * Returns false if no such sentence was found in a few attempts.
+         */
+        bool sampleNearMiss(size_t length, std::mt19937_64& rng, std::string& sentence) const;
+
+    private:
+        [[nodiscard]] long double count(size_t nt_code, size_t length) const noexcept {
+            return m_counts[length * m_cg.nt_count + nt_code];
+        }
+
+    private:
+        const algo::CompiledGrammar& m_cg;
+        size_t m_max_length;
+        std::vector<long double> m_counts;
+        std::string m_alphabet;
+
+        // The pairs (B, C) of all the rules A -> BC grouped by A
+        std::vector<size_t> m_head_offsets;
+        std::vector<std::pair<size_t, size_t>> m_head_pairs;
+    };
+}  // namespace fl::tools
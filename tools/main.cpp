@@ -0,0 +1,241 @@
+#include "RandomGrammar.h"
+#include "SentenceSampler.h"
+
+#include "GrammarAlgorithms.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr const char* const kHelpString =
+            "gc-cykp-gen: random grammars and corpora for gc-cykp\n"
+            "USAGE:\n"
+            "   gc-cykp-gen -G [-n <nt_count>] [-r <rules_count>] [-l <max_rule_length>] [-t <terminals_count>]\n"
+            "               [-e <nullable_density>] [-c <chain_depth>] [-a <ambiguity>] [-x <seed>]\n"
+            "   gc-cykp-gen -S <length> [-k <count>] [-q] [-x <seed>] <grammar_file>\n"
+            "OPTIONS:\n"
+            "   -G - print a random grammar, every nonterminal of it is reachable and generative\n"
+            "       -n - the number of nonterminals, 8 by default\n"
+            "       -r - the number of right sides of every nonterminal, 3 by default\n"
+            "       -l - the longest right side, 4 by default\n"
+            "       -t - the number of terminals, the letters from 'a', 4 by default\n"
+            "       -e - the probability of a nonterminal to have an empty right side, 0.1 by default\n"
+            "       -c - the length of the runs of chain rules, 0 by default\n"
+            "       -a - the probability of a nonterminal A to have the right side \"A A\", 0 by default\n"
+            "   -S - print sentences of <length> characters of the grammar, one per line,\n"
+            "        uniformly over the derivations of the grammar in the Chomsky form\n"
+            "       -k - the number of sentences, 1 by default\n"
+            "       -q - print near misses instead: the sentences with one character changed,\n"
+            "            which the grammar does not generate\n"
+            "   -x - the seed of the random generator, 1 by default\n";
+
+    struct GeneratorArguments {
+        bool need_help = false;
+        bool need_grammar = false;
+        bool need_near_misses = false;
+        std::optional<size_t> sentence_length;
+        size_t sentences_count = 1;
+        fl::tools::RandomGrammarOptions grammar_options;
+        std::optional<std::string> grammar_filename;
+    };
+
+    GeneratorArguments parseArguments(int argc, char* argv[]) {
+        GeneratorArguments args;
+
+        auto next_value = [&](int& i) -> std::string {
+            if (++i >= argc || argv[i][0] == '-') {
+                throw std::invalid_argument(std::string("expected a value after the '") + argv[i - 1] + "' flag.\n");
+            }
+
+            return argv[i];
+        };
+
+        auto next_size = [&](int& i) -> size_t {
+            const std::string value = next_value(i);
+
+            try {
+                return std::stoull(value);
+            }
+            catch (std::logic_error&) {
+                throw std::invalid_argument(std::string("expected a number after the '") + argv[i - 1] + "' flag.\n");
+            }
+        };
+
+        auto next_double = [&](int& i) -> double {
+            const std::string value = next_value(i);
+
+            try {
+                return std::stod(value);
+            }
+            catch (std::logic_error&) {
+                throw std::invalid_argument(std::string("expected a number after the '") + argv[i - 1] + "' flag.\n");
+            }
+        };
+
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+
+            if (arg[0] != '-') {
+                if (i + 1 != argc) {
+                    throw std::invalid_argument("the grammar path must be the last argument.\n");
+                }
+
+                args.grammar_filename = arg;
+                continue;
+            }
+
+            if (std::strlen(arg) != 2) {
+                throw std::invalid_argument("long flags (with more than 1 letter) are not allowed and not used.\n");
+            }
+
+            auto& options = args.grammar_options;
+
+            switch (arg[1]) {
+                case 'h': {
+                    args.need_help = true;
+                    break;
+                }
+
+                case 'G': {
+                    args.need_grammar = true;
+                    break;
+                }
+
+                case 'S': {
+                    args.sentence_length = next_size(i);
+                    break;
+                }
+
+                case 'k': {
+                    args.sentences_count = next_size(i);
+                    break;
+                }
+
+                case 'q': {
+                    args.need_near_misses = true;
+                    break;
+                }
+
+                case 'n': {
+                    options.nt_count = next_size(i);
+                    break;
+                }
+
+                case 'r': {
+                    options.rules_count = next_size(i);
+                    break;
+                }
+
+                case 'l': {
+                    options.max_rule_length = next_size(i);
+                    break;
+                }
+
+                case 't': {
+                    options.terminals_count = next_size(i);
+                    break;
+                }
+
+                case 'e': {
+                    options.nullable_density = next_double(i);
+                    break;
+                }
+
+                case 'c': {
+                    options.chain_depth = next_size(i);
+                    break;
+                }
+
+                case 'a': {
+                    options.ambiguity = next_double(i);
+                    break;
+                }
+
+                case 'x': {
+                    options.seed = next_size(i);
+                    break;
+                }
+
+                default: {
+                    throw std::invalid_argument(std::string("unknown flag '") + arg + "'.\n");
+                }
+            }
+        }
+
+        return args;
+    }
+
+    void printSentences(const GeneratorArguments& args) {
+        if (!args.grammar_filename) {
+            throw std::invalid_argument("a grammar file is not provided.\n");
+        }
+
+        std::ifstream fin(*args.grammar_filename);
+
+        if (!fin.good()) {
+            throw std::invalid_argument("failed to open the grammar file.\n");
+        }
+
+        fl::Grammar g;
+        fin >> g;
+
+        fl::algo::convertToChomskyForm(g, 0);
+
+        fl::algo::CompiledGrammar cg;
+        fl::algo::initCompiledGrammar(cg, g);
+
+        const size_t length = *args.sentence_length;
+        fl::tools::SentenceSampler sampler(cg, length);
+
+        if (!sampler.hasSentences(length)) {
+            throw std::invalid_argument("the grammar has no sentences of the length.\n");
+        }
+
+        std::mt19937_64 rng(args.grammar_options.seed);
+        std::string sentence;
+        size_t missed_count = 0;
+
+        for (size_t i = 0; i < args.sentences_count; ++i) {
+            if (!args.need_near_misses) {
+                std::cout << sampler.sample(length, rng) << '\n';
+            } else if (sampler.sampleNearMiss(length, rng, sentence)) {
+                std::cout << sentence << '\n';
+            } else {
+                ++missed_count;
+            }
+        }
+
+        // The grammar may generate almost every string around its sentences
+        if (missed_count != 0) {
+            std::cerr << "gc-cykp-gen: no near miss was found for " << missed_count << " of the sentences.\n";
+        }
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const auto args = parseArguments(argc, argv);
+
+        if (args.need_help || argc <= 1) {
+            std::cout << kHelpString;
+        } else if (args.need_grammar) {
+            fl::Grammar g;
+            fl::tools::generateRandomGrammar(g, args.grammar_options);
+            std::cout << g;
+        } else if (args.sentence_length) {
+            printSentences(args);
+        } else {
+            throw std::invalid_argument("no mode provided.\n");
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "gc-cykp-gen: " << e.what();
+        return 1;
+    }
+
+    return 0;
+}